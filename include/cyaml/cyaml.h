@@ -15,14 +15,25 @@
 #include "cyaml/event/event.h"
 
 // parser
+#include "cyaml/parser/output.h"
+#include "cyaml/parser/scalar_style.h"
+#include "cyaml/parser/emitter.h"
 #include "cyaml/parser/serializer.h"
 #include "cyaml/parser/parser.h"
 #include "cyaml/parser/api.h"
+#include "cyaml/parser/intern_table.h"
+#include "cyaml/parser/path_handler.h"
+#include "cyaml/parser/lazy_builder.h"
+#include "cyaml/parser/snapshot.h"
+#include "cyaml/parser/mapped_document.h"
 
 // node
 #include "cyaml/type/node/node.h"
 #include "cyaml/type/node/node_data.h"
 #include "cyaml/type/node/node_impl.h"
 #include "cyaml/type/node/convert.h"
+#include "cyaml/type/node/patch.h"
+#include "cyaml/type/node/path.h"
+#include "cyaml/type/node/usage.h"
 
 #endif // CYAML_H
@@ -33,6 +33,19 @@ namespace cyaml
         const char *const BAD_DEREFERENCE = "bad dereference";
         const char *const BAD_CONVERTION = "bad convertion";
         const char *const DUPLICATED_KEY = "duplicated key";
+        const char *const MODIFY_FROZEN = "modify frozen node";
+        const char *const INVALID_PATH = "invalid path expression";
+        const char *const UNCLOSED_COLLECTION = "unclosed collection";
+        const char *const UNMATCHED_END = "unmatched end of collection";
+        const char *const MISSING_VALUE = "missing value of key";
+        const char *const MULTIPLE_ROOTS = "multiple root nodes in document";
+        const char *const JSON_KEY = "json key should be a scalar";
+        const char *const TOO_DEEP = "node nesting exceeds maximum depth";
+        const char *const INVALID_SNAPSHOT = "invalid snapshot";
+        const char *const SNAPSHOT_VERSION =
+                "unsupported snapshot version or byte order";
+        const char *const SNAPSHOT_CHECKSUM = "snapshot checksum mismatch";
+        const char *const SNAPSHOT_TOO_LARGE = "snapshot larger than 4 GiB";
     } // namespace error_msgs
 } // namespace cyaml
 
@@ -107,6 +107,19 @@ namespace cyaml
         Convertion_Exception(const Convertion_Exception &) = default;
     };
 
+    /**
+     * @class   Frozen_Exception
+     * @brief   修改冻结节点异常
+     * @extends cyaml::Exception
+     */
+    class Frozen_Exception: public Representation_Exception
+    {
+    public:
+        Frozen_Exception();
+        ~Frozen_Exception() noexcept override;
+        Frozen_Exception(const Frozen_Exception &) = default;
+    };
+
 } // namespace cyaml
 
 #endif // CYAML_EXCEPTIONS_H
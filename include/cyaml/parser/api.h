@@ -8,80 +8,449 @@
 #ifndef CYAML_API_H
 #define CYAML_API_H
 
+#include "cyaml/parser/intern_table.h"
+#include "cyaml/parser/serializer.h"
 #include "cyaml/type/node/node.h"
+#include "cyaml/type/node/path.h"
 
 namespace cyaml
 {
     /**
      * @brief   从输入流加载
-     * @param   input   输入流
+     * @param   input       输入流
+     * @param   resource    节点内存资源
      * @return  Node
      */
-    Node load(std::istream &input);
+    Node load(
+            std::istream &input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从字符串加载
-     * @param   input   输入字符串
+     * @param   input       输入字符串
+     * @param   resource    节点内存资源
      * @return  Node
      */
-    Node load(const std::string &input);
+    Node load(
+            const std::string &input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从字符串加载
-     * @param   input   输入字符串
+     * @param   input       输入字符串
+     * @param   resource    节点内存资源
      * @return  Node
      */
-    Node load(const char *input);
+    Node load(
+            const char *input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从文件加载
-     * @param   file    文件路径
+     * @param   file        文件路径
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load_file(
+            const std::string &file,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从输入流加载，共享相同的节点数据
+     * @details 相同的标量和空值共享冻结的数据，对这些节点赋值只重新绑定
+     *          该节点，不会影响其它共享数据的节点；
+     *          mode 为 SUBTREE 时相同的集合子树以写时复制方式共享数据；
+     *          文档中出现锚点后不再共享子树
+     * @param   input       输入流
+     * @param   mode        共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            std::istream &input,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从字符串加载，共享相同的节点数据
+     * @param   input       输入字符串
+     * @param   mode        共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            const std::string &input,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从文件加载，共享相同的节点数据
+     * @param   file        文件路径
+     * @param   mode        共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load_file(
+            const std::string &file,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从输入流加载，map 的标量键从键表中取得
+     * @details 相同的键在使用同一键表的所有文档中共享数据，
+     *          每个不同的键只分配一次
+     * @param   input       输入流
+     * @param   key_table   键表，可以使用 Key_Table::global()
+     * @param   mode        其余节点的共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            std::istream &input,
+            Key_Table &key_table,
+            Intern_Mode mode = Intern_Mode::NONE,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从字符串加载，map 的标量键从键表中取得
+     * @param   input       输入字符串
+     * @param   key_table   键表
+     * @param   mode        其余节点的共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            const std::string &input,
+            Key_Table &key_table,
+            Intern_Mode mode = Intern_Mode::NONE,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从文件加载，map 的标量键从键表中取得
+     * @param   file        文件路径
+     * @param   key_table   键表
+     * @param   mode        其余节点的共享方式
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load_file(
+            const std::string &file,
+            Key_Table &key_table,
+            Intern_Mode mode = Intern_Mode::NONE,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从输入流加载选中的子树
+     * @details 只为选中的子树构建节点，其余部分在事件层面直接跳过；
+     *          返回的节点树只包含选中的子树及其所在路径上的集合，
+     *          sequence 中未选中的元素以空值占位，保证下标不变；
+     *          集合作为键时，其下的子树无法放入结果中
+     * @param   input       输入流
+     * @param   selector    选择条件，可以是路径、路径列表或位置判断函数
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            std::istream &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从字符串加载选中的子树
+     * @param   input       输入字符串
+     * @param   selector    选择条件
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load(
+            const std::string &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从文件加载选中的子树
+     * @param   file        文件路径
+     * @param   selector    选择条件
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load_file(
+            const std::string &file,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从字符串延迟加载
+     * @details 先完整解析一遍检查语法，但只构建根节点的直接子节点；
+     *          block 集合子节点只记录在源数据中的范围，
+     *          第一次访问时才解析该范围并构建其直接子节点；
+     *          源数据由返回的节点树共享，不需要调用方保留；
+     *          文档中存在锚点或别名、根节点不是 block 集合，
+     *          或者输入不是 utf-8 编码时完整加载；
+     *          子节点中的重复键在构建该子节点时才会报错；
+     *          未冻结的延迟节点在首次访问时会被修改，不能并发读取
+     * @param   input       输入字符串
+     * @param   resource    节点内存资源
      * @return  Node
      */
-    Node load_file(const std::string &file);
+    Node load_lazy(
+            std::string input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从文件延迟加载
+     * @param   file        文件路径
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    Node load_file_lazy(
+            const std::string &file,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从输入流加载全部节点
-     * @param   input   输入流
+     * @param   input       输入流
+     * @param   resource    节点内存资源
      * @return  std::vector<Node>
      */
-    std::vector<Node> load_all(std::istream &input);
+    std::vector<Node> load_all(
+            std::istream &input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从字符串加载全部节点
-     * @param   input   输入字符串
+     * @param   input       输入字符串
+     * @param   resource    节点内存资源
      * @return  std::vector<Node>
      */
-    std::vector<Node> load_all(const std::string &input);
+    std::vector<Node> load_all(
+            const std::string &input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从字符串加载全部节点
-     * @param   input   输入字符串
+     * @param   input       输入字符串
+     * @param   resource    节点内存资源
      * @return  std::vector<Node>
      */
-    std::vector<Node> load_all(const char *input);
+    std::vector<Node> load_all(
+            const char *input,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   从文件加载全部节点
-     * @param   file    文件路径
+     * @param   file        文件路径
+     * @param   resource    节点内存资源
      * @return  std::vector<Node>
      */
-    std::vector<Node> load_file_all(const std::string &file);
+    std::vector<Node> load_file_all(
+            const std::string &file,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从输入流查找匹配路径的节点
+     * @details 直接在解析事件流中匹配，只为匹配的子树构建节点；
+     *          与 Path::select 不同，匹配节点的子孙节点不会再单独返回，
+     *          例如 "/**" 只返回根节点
+     * @param   input       输入流
+     * @param   selector    选择条件，可以是路径、路径列表或位置判断函数
+     * @param   resource    节点内存资源
+     * @return  std::vector<Node>
+     */
+    std::vector<Node> select(
+            std::istream &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从字符串查找匹配路径的节点
+     * @param   input       输入字符串
+     * @param   selector    选择条件
+     * @param   resource    节点内存资源
+     * @return  std::vector<Node>
+     */
+    std::vector<Node> select(
+            const std::string &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从文件查找匹配路径的节点
+     * @param   file        文件路径
+     * @param   selector    选择条件
+     * @param   resource    节点内存资源
+     * @return  std::vector<Node>
+     */
+    std::vector<Node> select_file(
+            const std::string &file,
+            const Selector &selector,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   输出到文件
      * @param   file    文件路径
      * @param   node    节点
+     * @param   format  输出格式
      * @return  void
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
      */
-    void dump(const std::string &file, const Node &node);
+    void dump(
+            const std::string &file,
+            const Node &node,
+            Dump_Format format = Dump_Format::YAML);
 
     /**
      * @brief   转换为字符串
      * @param   node    节点
+     * @param   format  输出格式
      * @return  std::string
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
+     */
+    std::string dump(const Node &node, Dump_Format format = Dump_Format::YAML);
+
+    /**
+     * @brief   多线程转换为字符串，结果与 dump() 完全相同
+     * @details 只有冻结的节点树按根集合的条目分段并行输出，
+     *          否则按单线程输出
+     * @param   node    节点
+     * @param   format  输出格式
+     * @param   threads 线程数，为 0 时使用硬件线程数
+     * @return  std::string
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
+     */
+    std::string dump_parallel(
+            const Node &node,
+            Dump_Format format = Dump_Format::YAML,
+            size_t threads = 0);
+
+    /**
+     * @brief   计算输出长度，不写入任何内容
+     * @param   node    节点
+     * @param   format  输出格式
+     * @return  size_t
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
+     */
+    size_t dump_size(const Node &node, Dump_Format format = Dump_Format::YAML);
+
+    /**
+     * @brief   输出到字符串，替换原有内容
+     * @details 第一遍直接写入字符串已有的容量并计算准确长度，
+     *          容量足够时只输出一遍；不足时按准确长度调整一次大小后
+     *          再写入一遍，重复使用同一个字符串时不会重新分配内存
+     * @param   out     字符串
+     * @param   node    节点
+     * @param   format  输出格式
+     * @return  void
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
+     */
+    void dump_to(
+            std::string &out,
+            const Node &node,
+            Dump_Format format = Dump_Format::YAML);
+
+    /**
+     * @brief   输出到调用者提供的内存，不写入结束符
+     * @details 与 snprintf 类似，最多写入 capacity 个字节并返回完整长度，
+     *          返回值大于 capacity 时输出被截断
+     * @param   buffer      内存
+     * @param   capacity    容量
+     * @param   node        节点
+     * @param   format      输出格式
+     * @return  size_t
+     * @throw   Representation_Exception    JSON 格式中 map 的键是集合
+     */
+    size_t dump_to(
+            char *buffer,
+            size_t capacity,
+            const Node &node,
+            Dump_Format format = Dump_Format::YAML);
+
+    /**
+     * @brief   保留源数据的格式转换为字符串
+     * @details 用于修改 load_lazy() 加载的文档后写回：未修改的条目从源数据
+     *          中整段复制，注释、空行、引号和缩进保持不变，只有修改或新增
+     *          的条目按 dump() 的格式输出，没有构建过的子树不需要遍历；
+     *          不是延迟加载的文档与 dump() 相同
+     * @param   node    load_lazy() 返回的根节点
+     * @return  std::string
+     * @throw   Representation_Exception    嵌套层数超过限制
+     */
+    std::string dump_preserved(const Node &node);
+
+    /**
+     * @brief   保留源数据的格式输出到文件
+     * @param   file    文件路径
+     * @param   node    load_lazy() 返回的根节点
+     * @return  void
+     * @throw   Representation_Exception    嵌套层数超过限制
+     */
+    void dump_preserved(const std::string &file, const Node &node);
+
+    /**
+     * @brief   保存为二进制快照
+     * @details 快照记录节点类型、样式和标量内容，不记录注释和锚点，
+     *          使用 load_snapshot() 加载时不需要重新解析
+     * @param   node    节点
+     * @return  std::string
+     * @throw   Representation_Exception    快照超过 4 GiB
+     */
+    std::string save_snapshot(const Node &node);
+
+    /**
+     * @brief   保存二进制快照到文件
+     * @param   file    文件路径
+     * @param   node    节点
+     * @return  void
+     * @throw   Representation_Exception    快照超过 4 GiB
+     */
+    void save_snapshot(const std::string &file, const Node &node);
+
+    /**
+     * @brief   从二进制快照加载
+     * @details 先检查文件头和校验和，保存时已冻结的节点树加载后冻结
+     * @param   data        快照
+     * @param   resource    节点内存资源
+     * @return  Node
+     * @throw   Parse_Exception     快照损坏，或由不同版本、字节序写入
+     */
+    Node load_snapshot(
+            std::string_view data,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
+
+    /**
+     * @brief   从二进制快照文件加载
+     * @param   file        文件路径
+     * @param   resource    节点内存资源
+     * @return  Node
+     * @throw   Parse_Exception     快照损坏，或由不同版本、字节序写入
      */
-    std::string dump(const Node &node);
+    Node load_snapshot_file(
+            const std::string &file,
+            std::pmr::memory_resource *resource =
+                    std::pmr::get_default_resource());
 
     /**
      * @brief   通过标准输出流 << 运算符输出
@@ -0,0 +1,297 @@
+/**
+ * @file        emitter.h
+ * @brief       事件驱动的流式输出
+ * @details     主要包含 Emitter 类声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_EMITTER_H
+#define CYAML_EMITTER_H
+
+#include "cyaml/event/event.h"
+#include "cyaml/parser/output.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @class   Emitter
+     * @brief   不构建节点树，按事件直接输出 YAML
+     * @details 输出格式与 Serializer 相同，每个节点的布局在开始时确定，
+     *          只记录每层集合的状态，内存占用与嵌套深度成正比；
+     *          继承 Event_Handler，可以直接接收 Parser 的事件，
+     *          锚点和别名按原样输出而不展开
+     */
+    class Emitter: public Event_Handler
+    {
+    private:
+        /**
+         * @struct  Frame
+         * @brief   正在输出的集合
+         */
+        struct Frame
+        {
+            bool map;             // 是否为 map
+            bool flow;            // 是否为流式
+            uint32_t indent;      // 子节点缩进
+            bool first = true;    // 是否还没有子节点
+            bool key_turn = true; // map 中下一个节点是否为键
+        };
+
+        Output output_;             // 输出
+        uint32_t indent_inc_ = 2;   // 每级缩进长度
+        std::vector<Frame> frames_; // 集合栈
+        bool root_done_ = false;    // 当前文档的根节点是否已输出
+
+    public:
+        /**
+         * @brief   输出到输出流
+         * @param   out     输出流
+         */
+        explicit Emitter(std::ostream &out);
+
+        /**
+         * @brief   输出到文件描述符
+         * @param   fd      文件描述符
+         */
+        explicit Emitter(int fd);
+
+        /**
+         * @brief   追加到字符串
+         * @param   out     字符串
+         */
+        explicit Emitter(std::string &out);
+
+        /**
+         * @brief   开始新文档，不是第一个文档时先输出文档分隔符
+         * @return  void
+         * @throw   Exception   上一个文档还有未结束的集合
+         */
+        void begin_document();
+
+        /**
+         * @brief   结束当前文档，并写出缓冲区中的内容
+         * @return  void
+         * @throw   Exception   还有未结束的集合
+         */
+        void end_document();
+
+        /**
+         * @brief   开始 map，之后的节点依次作为键和值
+         * @param   style   风格，位于流式集合中时总是流式
+         * @param   anchor  锚点名，为空时不输出
+         * @return  void
+         * @throw   Exception   当前文档的根节点已经结束
+         */
+        void begin_map(
+                Node_Style style = Node_Style::BLOCK,
+                std::string_view anchor = {});
+
+        /**
+         * @brief   结束 map
+         * @return  void
+         * @throw   Exception   当前集合不是 map，或最后一个键没有值
+         */
+        void end_map();
+
+        /**
+         * @brief   开始 sequence
+         * @param   style   风格，位于流式集合中时总是流式
+         * @param   anchor  锚点名，为空时不输出
+         * @return  void
+         * @throw   Exception   当前文档的根节点已经结束
+         */
+        void begin_seq(
+                Node_Style style = Node_Style::BLOCK,
+                std::string_view anchor = {});
+
+        /**
+         * @brief   结束 sequence
+         * @return  void
+         * @throw   Exception   当前集合不是 sequence
+         */
+        void end_seq();
+
+        /**
+         * @brief   输出标量，按内容选择引号、转义或块字面量
+         * @param   value   标量值
+         * @param   anchor  锚点名，为空时不输出
+         * @return  void
+         * @throw   Exception   当前文档的根节点已经结束
+         */
+        void scalar(std::string_view value, std::string_view anchor = {});
+
+        /**
+         * @brief   输出空值
+         * @param   anchor  锚点名，为空时不输出
+         * @return  void
+         * @throw   Exception   当前文档的根节点已经结束
+         */
+        void null(std::string_view anchor = {});
+
+        /**
+         * @brief   输出别名
+         * @param   name    锚点名
+         * @return  void
+         * @throw   Exception   当前文档的根节点已经结束
+         */
+        void alias(std::string_view name);
+
+        /**
+         * @brief   写出缓冲区中的内容
+         * @return  void
+         */
+        void flush()
+        {
+            output_.flush();
+        }
+
+        /**
+         * @brief   获取当前行
+         * @return  uint32_t
+         */
+        uint32_t line() const
+        {
+            return output_.line();
+        }
+
+        /**
+         * @brief   获取当前列
+         * @return  uint32_t
+         */
+        uint32_t column() const
+        {
+            return output_.column();
+        }
+
+        // events derived from Event_Handler
+        void on_document_start(const Mark &mark) override
+        {
+            begin_document();
+        }
+
+        void on_document_end() override
+        {
+            end_document();
+        }
+
+        void on_map_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override
+        {
+            begin_map(style, anchor);
+        }
+
+        void on_map_end() override
+        {
+            end_map();
+        }
+
+        void on_seq_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override
+        {
+            begin_seq(style, anchor);
+        }
+
+        void on_seq_end() override
+        {
+            end_seq();
+        }
+
+        void on_scalar(const Mark &mark, std::string anchor, std::string value)
+                override
+        {
+            scalar(value, anchor);
+        }
+
+        void on_null(const Mark &mark, std::string anchor) override
+        {
+            null(anchor);
+        }
+
+        void on_anchor(const Mark &mark, std::string anchor) override{};
+
+        void on_alias(const Mark &mark, std::string anchor) override
+        {
+            alias(anchor);
+        }
+
+    private:
+        /**
+         * @brief   计算下一级缩进
+         * @param   indent      当前缩进
+         * @return  uint32_t
+         */
+        uint32_t increase(uint32_t indent) const
+        {
+            return indent + indent_inc_;
+        }
+
+        /**
+         * @brief   填充空白字符到目标位置
+         * @param   indent      缩进位置
+         * @return  void
+         */
+        void fill_blank(uint32_t indent);
+
+        /**
+         * @brief   判断是否位于流式集合中
+         * @return  bool
+         */
+        bool in_flow() const
+        {
+            return !frames_.empty() && frames_.back().flow;
+        }
+
+        /**
+         * @brief   输出节点之前的分隔符、缩进和锚点
+         * @param   block   节点是否为块集合
+         * @param   anchor  锚点名
+         * @return  void
+         */
+        void begin_node(bool block, std::string_view anchor);
+
+        /**
+         * @brief   节点结束后换行并更新所在集合的状态
+         * @param   block   节点是否为块集合
+         * @return  void
+         */
+        void end_node(bool block);
+
+        /**
+         * @brief   开始集合
+         * @param   map     是否为 map
+         * @param   style   风格
+         * @param   anchor  锚点名
+         * @return  void
+         */
+        void begin_collection(
+                bool map,
+                Node_Style style,
+                std::string_view anchor);
+
+        /**
+         * @brief   结束集合
+         * @param   map     是否为 map
+         * @return  void
+         */
+        void end_collection(bool map);
+
+        /**
+         * @brief   抛出调用顺序错误
+         * @param   msg     错误信息
+         * @return  void
+         * @throw   Exception
+         */
+        [[noreturn]] void fail(const char *msg) const;
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_EMITTER_H
@@ -0,0 +1,163 @@
+/**
+ * @file        intern_table.h
+ * @brief       加载时共享相同的节点数据
+ * @details     主要包含 Intern_Table 和 Key_Table 类声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_INTERN_TABLE_H
+#define CYAML_INTERN_TABLE_H
+
+#include "cyaml/type/node/node.h"
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cyaml
+{
+    /**
+     * @enum    Intern_Mode
+     * @brief   加载时共享节点数据的方式
+     */
+    enum class Intern_Mode
+    {
+        NONE,   // 不共享
+        SCALAR, // 相同的标量和空值共享数据
+        SUBTREE // 同时共享相同的集合子树
+    };
+
+    /**
+     * @class   Intern_Table
+     * @brief   单次加载使用的节点数据共享表
+     * @details 标量和空值共享冻结的节点数据，对节点赋值只重新绑定该节点；
+     *          相同的集合子树共享冻结的数据，节点以写时复制方式引用，
+     *          修改时只复制被修改的一层，对使用者透明
+     */
+    class Intern_Table
+    {
+    private:
+        Intern_Mode mode_;
+        std::pmr::memory_resource *resource_; // 节点内存资源
+
+        Node_Ptr null_; // 共享的空值
+        std::unordered_map<std::string_view, Node_Ptr> scalars_;
+        std::unordered_multimap<size_t, Node_Ptr> subtrees_; // 按哈希索引
+
+    public:
+        /**
+         * @brief   Intern_Table 类构造函数
+         * @param   mode        共享方式
+         * @param   resource    节点内存资源
+         */
+        Intern_Table(
+                Intern_Mode mode,
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource());
+
+        /**
+         * @brief   获取共享方式
+         * @return  Intern_Mode
+         */
+        Intern_Mode mode() const
+        {
+            return mode_;
+        }
+
+        /**
+         * @brief   创建共享数据的标量节点
+         * @param   value   标量值
+         * @return  Node_Ptr
+         */
+        Node_Ptr scalar(const std::string &value);
+
+        /**
+         * @brief   创建共享数据的空值节点
+         * @return  Node_Ptr
+         */
+        Node_Ptr null();
+
+        /**
+         * @brief   记录构建完成的集合
+         * @details 与已记录的子树相同时，节点改为引用共享的冻结数据，
+         *          原有子节点被释放；第一次出现重复时才将已记录的子树
+         *          转移到冻结数据中，不重复的子树没有额外开销；
+         *          哈希由构建器在子节点完成时逐层合并得到，不重新遍历子树
+         * @param   node    构建完成的集合节点
+         * @param   hash    节点的结构哈希，与 Node::hash() 相同
+         * @return  void
+         */
+        void subtree(const Node_Ptr &node, size_t hash);
+    };
+
+    /**
+     * @class   Key_Table
+     * @brief   跨文档共享的 map 键表
+     * @details 加载时 map 的标量键从表中取得，相同的键在所有文档中共享
+     *          同一份冻结数据，哈希在加入时计算；
+     *          查找时键的数据相同即直接判定相等，不同时先比较缓存的哈希；
+     *          可以被多个线程同时使用，已有的键在读锁下查找，
+     *          只有加入新键时才加写锁；表中的键只增加不删除，
+     *          键的数据由表和引用它的节点共同持有
+     */
+    class Key_Table
+    {
+    private:
+        std::pmr::memory_resource *resource_; // 键数据内存资源
+
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string_view, Node_Ptr> keys_;
+
+    public:
+        /**
+         * @brief   Key_Table 类构造函数
+         * @param   resource    键数据内存资源，需要是线程安全的
+         */
+        explicit Key_Table(
+                std::pmr::memory_resource *resource =
+                        std::pmr::new_delete_resource());
+        Key_Table(const Key_Table &) = delete;
+        Key_Table &operator=(const Key_Table &) = delete;
+
+        /**
+         * @brief   获取进程共享的键表
+         * @return  Key_Table &
+         */
+        static Key_Table &global();
+
+        /**
+         * @brief   获取键节点，可用于快速查找
+         * @param   key     键
+         * @return  Node
+         */
+        Node key(const std::string &key);
+
+        /**
+         * @brief   在指定内存资源上创建共享数据的键节点
+         * @param   key         键
+         * @param   resource    节点内存资源
+         * @return  Node_Ptr
+         */
+        Node_Ptr make_key(
+                const std::string &key,
+                std::pmr::memory_resource *resource);
+
+        /**
+         * @brief   获取不同键的个数
+         * @return  size_t
+         */
+        size_t size() const;
+
+    private:
+        /**
+         * @brief   查找或加入键
+         * @param   key     键
+         * @return  const Node &
+         */
+        const Node &find(const std::string &key);
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_INTERN_TABLE_H
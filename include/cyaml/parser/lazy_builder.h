@@ -0,0 +1,207 @@
+/**
+ * @file        lazy_builder.h
+ * @brief       延迟构建节点树
+ * @details     继承 Event_Handler，每次只构建一层子节点，
+ *              block 集合子节点只记录在源数据中的范围，访问时再构建
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_LAZY_BUILDER_H
+#define CYAML_LAZY_BUILDER_H
+
+#include "cyaml/event/event.h"
+#include "cyaml/parser/node_builder.h"
+#include "cyaml/type/node/node.h"
+#include <memory>
+#include <string>
+
+namespace cyaml
+{
+    /**
+     * @class   Lazy_Builder
+     * @brief   延迟构建节点树
+     * @details 标量、flow 集合和集合键直接构建；
+     *          block 集合子节点只记录范围，访问时重新解析该范围，
+     *          解析前在开头补齐 (列号 - 1) 个空格，保持原有缩进；
+     *          构建后保留范围和各条目的起始位置，用于保留格式输出；
+     *          文档中存在锚点或别名时无法延迟构建，需要完整加载
+     */
+    class Lazy_Builder: public Event_Handler
+    {
+    private:
+        std::shared_ptr<const std::string> buffer_; // 源数据
+        uint32_t begin_;                            // 解析范围起始偏移
+        uint32_t end_;                              // 解析范围结束偏移
+        uint32_t pad_;                              // 开头补齐的空格数
+
+        std::pmr::memory_resource *resource_; // 节点内存资源
+
+        Node_Ptr root_;           // 构建的根节点
+        uint32_t root_begin_ = 0; // 根节点第一个条目的偏移
+        Node_Data *data_;         // 正在构建子节点的集合数据
+        Node_Type type_;          // 正在构建子节点的集合类型
+        uint32_t indent_ = 0;     // 正在构建子节点的集合缩进
+        uint32_t depth_ = 0;      // 当前集合层数
+        bool key_turn_ = true;    // map 的下一个子节点是否为键
+        Node_Ptr key_;            // 等待值的键
+        uint32_t skip_ = 0;       // 延迟子节点中跳过的集合层数
+        Node_Builder capture_;    // 直接构建的集合子节点
+        uint32_t captured_ = 0;   // 直接构建的集合层数
+        Mark capture_mark_;       // 直接构建的集合子节点位置
+
+        bool eager_ = false; // 是否需要完整加载
+
+    public:
+        /**
+         * @brief   Lazy_Builder 类构造函数
+         * @param   buffer      源数据
+         * @param   begin       解析范围起始偏移
+         * @param   end         解析范围结束偏移
+         * @param   pad         开头补齐的空格数
+         * @param   target      需要构建子节点的集合，为空时构建根节点
+         * @param   resource    节点内存资源
+         */
+        Lazy_Builder(
+                std::shared_ptr<const std::string> buffer,
+                uint32_t begin,
+                uint32_t end,
+                uint32_t pad,
+                const Node *target,
+                std::pmr::memory_resource *resource);
+        ~Lazy_Builder() override = default;
+
+        /**
+         * @brief   从源数据延迟加载节点树
+         * @details 根节点不是 block 集合，或者文档中存在锚点时完整加载
+         * @param   buffer      源数据，需要为 utf-8 编码
+         * @param   resource    节点内存资源
+         * @return  Node
+         */
+        static Node load(
+                std::shared_ptr<const std::string> buffer,
+                std::pmr::memory_resource *resource);
+
+        /**
+         * @brief   构建延迟加载节点的直接子节点
+         * @param   node    延迟加载的节点
+         * @return  void
+         */
+        static void materialize(const Node &node);
+
+        // events derived from Event_Handler
+        void on_document_start(const Mark &mark) override{};
+
+        void on_document_end() override{};
+
+        void on_map_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override;
+
+        void on_map_end() override;
+
+        void on_seq_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override;
+
+        void on_seq_end() override;
+
+        void on_scalar(const Mark &mark, std::string anchor, std::string value)
+                override;
+
+        void on_null(const Mark &mark, std::string anchor) override;
+
+        void on_anchor(const Mark &mark, std::string anchor) override{};
+
+        void on_alias(const Mark &mark, std::string anchor) override;
+
+    private:
+        /**
+         * @brief   将解析位置转换为源数据偏移
+         * @param   mark    解析位置
+         * @return  uint32_t
+         */
+        uint32_t offset(const Mark &mark) const
+        {
+            return begin_ + mark.offset - pad_;
+        }
+
+        /**
+         * @brief   将解析位置转换为源数据中的位置，用于错误信息
+         * @param   mark    解析位置
+         * @return  Mark
+         */
+        Mark source_mark(const Mark &mark) const;
+
+        /**
+         * @brief   处理集合开始事件
+         * @param   type    集合类型
+         * @param   mark    集合位置
+         * @param   anchor  锚点
+         * @param   style   集合样式
+         * @return  void
+         */
+        void begin_collection(
+                Node_Type type,
+                const Mark &mark,
+                const std::string &anchor,
+                Node_Style style);
+
+        /**
+         * @brief   处理集合结束事件
+         * @return  void
+         */
+        void end_collection();
+
+        /**
+         * @brief   计算 block 集合子节点在源数据中的结束位置
+         * @details 子节点第一行之后，缩进不大于父集合的非空行即为结束；
+         *          不缩进的 sequence 中以 "- " 开头的行仍属于子节点
+         * @param   begin       子节点起始偏移
+         * @param   indentless  子节点是否为不缩进的 sequence
+         * @return  uint32_t
+         */
+        uint32_t block_end(uint32_t begin, bool indentless) const;
+
+        /**
+         * @brief   记录 block 集合各条目在源数据中的起始位置
+         * @details 条目从缩进等于集合列号的行开始，注释、空行和缩进更多的
+         *          行属于前一个条目；map 中以 ": " 和 "- " 开头的行是
+         *          前一个条目的值；根节点遇到文档标记时结束；
+         *          找到的条目数与已构建的子节点数不同时不记录
+         * @param   range   集合在源数据中的范围
+         * @param   map     集合是否为 map
+         * @param   count   已构建的子节点数
+         * @return  bool
+         * @retval  true:   记录成功
+         */
+        static bool scan_entries(Lazy_Range &range, bool map, size_t count);
+
+        /**
+         * @brief   记录节点由源数据构建，包括直接构建的全部子节点
+         * @param   node    节点
+         * @return  void
+         */
+        static void track(const Node &node);
+
+        /**
+         * @brief   处理标量、空值和别名事件
+         * @param   anchor  锚点
+         * @return  bool
+         * @retval  true:   节点是需要构建的直接子节点
+         */
+        bool scalar_node(const std::string &anchor);
+
+        /**
+         * @brief   添加直接子节点
+         * @param   node    子节点
+         * @param   mark    子节点位置
+         * @return  void
+         */
+        void add_child(const Node_Ptr &node, const Mark &mark);
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_LAZY_BUILDER_H
@@ -0,0 +1,265 @@
+/**
+ * @file        mapped_document.h
+ * @brief       映射到内存的只读快照
+ * @details     主要包含 Mapped_Node、Mapped_Document 类声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_MAPPED_DOCUMENT_H
+#define CYAML_MAPPED_DOCUMENT_H
+
+#include "cyaml/parser/snapshot.h"
+#include "cyaml/type/node/node.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cyaml
+{
+    /**
+     * @class   Mapped_Node
+     * @brief   快照中的只读节点
+     * @details 只记录节点在快照中的位置，直接读取快照内容，
+     *          访问时不分配内存；构造时检查节点记录的范围，
+     *          子节点必须位于父节点之后，损坏的快照不会导致越界读取；
+     *          在所属的 Mapped_Document 销毁前有效
+     */
+    class Mapped_Node
+    {
+    private:
+        const char *body_; // 快照数据区
+        size_t limit_;     // 数据区长度
+        uint32_t offset_;  // 节点记录的偏移
+
+        Node_Type type_;   // 节点类型
+        Node_Style style_; // 节点样式
+        uint32_t size_;    // 标量长度或集合元素个数
+
+    public:
+        /**
+         * @brief   读取快照中的节点记录
+         * @param   body    快照数据区
+         * @param   limit   数据区长度
+         * @param   offset  节点记录的偏移
+         * @throw   Parse_Exception     节点记录错误
+         */
+        Mapped_Node(const char *body, size_t limit, uint32_t offset);
+
+        /**
+         * @brief   获取值的类型
+         * @return  Node_Type
+         */
+        Node_Type type() const
+        {
+            return type_;
+        }
+
+        /**
+         * @brief   获取节点样式
+         * @return  Node_Style
+         */
+        Node_Style style() const
+        {
+            return style_;
+        }
+
+        /**
+         * @brief   获取集合元素个数，标量和空值为 0
+         * @return  uint32_t
+         */
+        uint32_t size() const
+        {
+            return is_collection() ? size_ : 0;
+        }
+
+        /**
+         * @brief   判断是否为空值
+         * @return  bool
+         */
+        bool is_null() const
+        {
+            return type_ == Node_Type::NONE;
+        }
+
+        /**
+         * @brief   判断是否为 map
+         * @return  bool
+         */
+        bool is_map() const
+        {
+            return type_ == Node_Type::MAP;
+        }
+
+        /**
+         * @brief   判断是否为 sequence
+         * @return  bool
+         */
+        bool is_seq() const
+        {
+            return type_ == Node_Type::SEQ;
+        }
+
+        /**
+         * @brief   判断是否为集合
+         * @return  bool
+         */
+        bool is_collection() const
+        {
+            return is_map() || is_seq();
+        }
+
+        /**
+         * @brief   判断是否为标量
+         * @return  bool
+         */
+        bool is_scalar() const
+        {
+            return type_ == Node_Type::SCALAR;
+        }
+
+        /**
+         * @brief   获取标量视图，直接指向快照内容
+         * @return  std::string_view    不是标量时为空
+         */
+        std::string_view scalar_view() const
+        {
+            if (!is_scalar())
+                return {};
+
+            return std::string_view(
+                    body_ + offset_ + sizeof(Snapshot_Record), size_);
+        }
+
+        /**
+         * @brief   获取标量
+         * @return  std::string
+         */
+        std::string scalar() const
+        {
+            return std::string(scalar_view());
+        }
+
+        /**
+         * @brief   按 YAML core schema 解析标量，每次调用都重新解析
+         * @return  Scalar_Value
+         */
+        Scalar_Value resolve() const
+        {
+            return resolve_scalar(scalar_view());
+        }
+
+        /**
+         * @brief   获取序列元素
+         * @param   index   元素索引值
+         * @return  Mapped_Node
+         * @throw   Dereference_Exception   不是 sequence 或索引越界
+         */
+        Mapped_Node operator[](uint32_t index) const;
+
+        /**
+         * @brief   按标量键查找 map 的值
+         * @details 条目较多的 map 通过快照中的哈希索引查找，
+         *          其余逐个比较
+         * @param   key     键
+         * @return  Mapped_Node
+         * @throw   Dereference_Exception   不是 map 或键不存在
+         */
+        Mapped_Node operator[](std::string_view key) const;
+
+        /**
+         * @brief   判断 map 中是否存在标量键
+         * @param   key     键
+         * @return  bool
+         */
+        bool contain(std::string_view key) const
+        {
+            return find(key) != size_;
+        }
+
+        /**
+         * @brief   获取 map 中第 index 个条目的键
+         * @param   index   条目序号，按原有顺序
+         * @return  Mapped_Node
+         * @throw   Dereference_Exception   不是 map 或序号越界
+         */
+        Mapped_Node key(uint32_t index) const;
+
+        /**
+         * @brief   获取 map 中第 index 个条目的值
+         * @param   index   条目序号，按原有顺序
+         * @return  Mapped_Node
+         * @throw   Dereference_Exception   不是 map 或序号越界
+         */
+        Mapped_Node value(uint32_t index) const;
+
+    private:
+        /**
+         * @brief   读取第 slot 个子节点
+         * @param   slot    子节点偏移的序号，map 中键和值依次排列
+         * @return  Mapped_Node
+         */
+        Mapped_Node child(size_t slot) const;
+
+        /**
+         * @brief   查找标量键所在的条目
+         * @param   key     键
+         * @return  uint32_t    条目序号，不存在或不是 map 时为 size_
+         */
+        uint32_t find(std::string_view key) const;
+
+        /**
+         * @brief   判断第 entry 个条目的键是否等于 key
+         * @param   entry   条目序号
+         * @param   key     键
+         * @return  bool
+         */
+        bool key_equal(uint32_t entry, std::string_view key) const;
+    };
+
+    /**
+     * @class   Mapped_Document
+     * @brief   以只读方式映射快照文件，不构建节点树
+     * @details 快照格式与 save_snapshot() 相同，节点之间只通过偏移引用，
+     *          映射到任意地址都可以直接访问；多个进程映射同一文件时
+     *          共享页缓存中的同一份数据；
+     *          文件在映射期间不能被修改
+     */
+    class Mapped_Document
+    {
+    private:
+        void *map_ = nullptr; // 映射的起始地址
+        size_t length_ = 0;   // 映射长度
+        const char *body_;    // 数据区
+        size_t size_;         // 数据区长度
+
+    public:
+        /**
+         * @brief   映射快照文件
+         * @details 不检查校验和时只读取文件头，打开时间与文件大小无关；
+         *          访问节点时仍会检查偏移的范围
+         * @param   file    文件路径
+         * @param   verify  是否检查数据区校验和
+         * @throw   Exception           无法打开或映射文件
+         * @throw   Parse_Exception     格式错误、版本或字节序不同、
+         *                              校验和不一致
+         */
+        explicit Mapped_Document(const std::string &file, bool verify = true);
+        ~Mapped_Document();
+
+        Mapped_Document(const Mapped_Document &) = delete;
+        Mapped_Document &operator=(const Mapped_Document &) = delete;
+
+        /**
+         * @brief   获取根节点
+         * @return  Mapped_Node
+         * @throw   Parse_Exception     节点记录错误
+         */
+        Mapped_Node root() const
+        {
+            return Mapped_Node(body_, size_, 0);
+        }
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_MAPPED_DOCUMENT_H
@@ -9,7 +9,9 @@
 #define CYAML_NODE_BUILDER_H
 
 #include "cyaml/event/event.h"
+#include "cyaml/parser/intern_table.h"
 #include "cyaml/type/node/node.h"
+#include <memory>
 #include <stack>
 
 namespace cyaml
@@ -19,12 +21,28 @@ namespace cyaml
     private:
         Node_Ptr root_;
         std::stack<Node_Ptr> nodes_;
-        std::unordered_set<Node_Ptr> keys_;
+        std::stack<size_t> hashes_; // 共享子树时与 nodes_ 对应的结构哈希
+        std::unordered_set<const Node *> keys_; // 正在等待值的键节点
         std::unordered_map<std::string, Node_Ptr> anchor_map_;
         Mark mark_;
 
+        std::pmr::memory_resource *resource_; // 节点内存资源
+
+        std::unique_ptr<Intern_Table> intern_; // 共享节点数据，不共享时为空
+        Key_Table *key_table_;                 // 跨文档共享的键表，可以为空
+
     public:
-        Node_Builder();
+        /**
+         * @brief   Node_Builder 类构造函数
+         * @param   resource    构建节点树使用的内存资源
+         * @param   mode        共享相同节点数据的方式
+         * @param   key_table   跨文档共享的键表，为空时不共享
+         */
+        Node_Builder(
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource(),
+                Intern_Mode mode = Intern_Mode::NONE,
+                Key_Table *key_table = nullptr);
         ~Node_Builder() = default;
 
         // events derived from Event_Handler
@@ -65,6 +83,35 @@ namespace cyaml
         Node root();
 
     private:
+        /**
+         * @brief   在内存资源上创建节点
+         * @param   type    节点类型
+         * @return  Node_Ptr
+         */
+        Node_Ptr make_node(Node_Type type)
+        {
+            return make_pmr_shared<Node>(resource_, type, resource_);
+        }
+
+        /**
+         * @brief   判断下一个完成的节点是否为 map 的键
+         * @return  bool
+         */
+        bool in_key() const
+        {
+            return !nodes_.empty() && nodes_.top()->is_map() &&
+                   keys_.find(nodes_.top().get()) == keys_.end();
+        }
+
+        /**
+         * @brief   压入一个节点
+         * @details 共享子树时同时记录节点的结构哈希，集合的哈希从类型开始，
+         *          在子节点弹出时逐个合并，与 Node::hash() 的结果相同
+         * @param   node    节点
+         * @return  void
+         */
+        void push_node(const Node_Ptr &node);
+
         /**
          * @brief   弹出一个节点，建立节点关系
          * @return  void
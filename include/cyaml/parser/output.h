@@ -0,0 +1,219 @@
+/**
+ * @file        output.h
+ * @brief       带缓冲的输出
+ * @details     主要包含 Output 类声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_OUTPUT_H
+#define CYAML_OUTPUT_H
+
+#include "cyaml/type/mark.h"
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace cyaml
+{
+    /**
+     * @class   Output
+     * @brief   带缓冲的输出
+     * @details 内容先写入内部缓冲区，缓冲区满或调用 flush() 时
+     *          整块写入输出流、文件描述符或字符串；
+     *          输出到调用者提供的内存时直接写入该内存，不使用内部缓冲区，
+     *          超出容量的部分只计入长度；
+     *          写入时增量计算当前行列，缩进和换行直接从常量中复制，
+     *          除缓冲区外不分配内存
+     */
+    class Output
+    {
+    public:
+        static constexpr size_t BUFFER_SIZE = 64 * 1024; // 缓冲区大小
+
+    private:
+        /**
+         * @enum    Target
+         * @brief   输出目标类型
+         */
+        enum class Target
+        {
+            STREAM,
+            FD,
+            STRING,
+            MEMORY
+        };
+
+        Target target_;
+        std::ostream *stream_ = nullptr;
+        int fd_ = -1;
+        std::string *string_ = nullptr;
+
+        std::unique_ptr<char[]> storage_; // 内部缓冲区
+        char *begin_ = nullptr;           // 缓冲区开始
+        char *cur_ = nullptr;             // 下一个写入位置
+        char *end_ = nullptr;             // 缓冲区结束
+        size_t flushed_ = 0;              // 已写入输出目标的长度
+        size_t dropped_ = 0;              // 超出内存容量未写入的长度
+
+        Mark mark_{1, 1}; // 当前输出位置
+
+    public:
+        /**
+         * @brief   输出到输出流
+         * @param   out     输出流
+         */
+        explicit Output(std::ostream &out);
+
+        /**
+         * @brief   输出到文件描述符，不会关闭该描述符
+         * @param   fd      文件描述符
+         */
+        explicit Output(int fd);
+
+        /**
+         * @brief   追加到字符串
+         * @param   out     字符串
+         */
+        explicit Output(std::string &out);
+
+        /**
+         * @brief   直接写入调用者提供的内存，不写入结束符
+         * @details buffer 为空且容量为 0 时只计算输出长度
+         * @param   buffer      内存
+         * @param   capacity    容量
+         */
+        Output(char *buffer, size_t capacity);
+
+        Output(const Output &) = delete;
+        Output &operator=(const Output &) = delete;
+
+        /**
+         * @brief   析构时写出缓冲区中剩余的内容，忽略写入错误
+         */
+        ~Output();
+
+        /**
+         * @brief   写入字符串
+         * @param   str     写入内容
+         * @return  void
+         */
+        void write(std::string_view str);
+
+        /**
+         * @brief   写入单个字符
+         * @param   ch      写入内容
+         * @return  void
+         */
+        void write(char ch);
+
+        /**
+         * @brief   写入指定个数空格
+         * @param   count   空格个数
+         * @return  void
+         */
+        void write_space(uint32_t count = 1);
+
+        /**
+         * @brief   写入指定个数换行
+         * @param   count   换行个数
+         * @return  void
+         */
+        void write_new_line(uint32_t count = 1);
+
+        /**
+         * @brief   写入字符串，不计算行列，用于不需要缩进的紧凑格式
+         * @param   str     写入内容
+         * @return  void
+         */
+        void write_raw(std::string_view str)
+        {
+            append(str.data(), str.size());
+        }
+
+        /**
+         * @brief   写入单个字符，不计算行列
+         * @param   ch      写入内容
+         * @return  void
+         */
+        void write_raw(char ch)
+        {
+            if (cur_ == end_) {
+                spill(&ch, 1);
+            } else {
+                *cur_++ = ch;
+            }
+        }
+
+        /**
+         * @brief   将缓冲区中的内容写入输出目标，输出到内存时不做处理
+         * @return  void
+         * @throw   Exception   写入文件描述符失败
+         */
+        void flush();
+
+        /**
+         * @brief   获取已输出的总长度，包括超出内存容量未写入的部分
+         * @return  size_t
+         */
+        size_t size() const
+        {
+            return flushed_ + (cur_ - begin_) + dropped_;
+        }
+
+        /**
+         * @brief   获取当前行
+         * @return  uint32_t
+         */
+        uint32_t line() const
+        {
+            return mark_.line;
+        }
+
+        /**
+         * @brief   获取当前列
+         * @return  uint32_t
+         */
+        uint32_t column() const
+        {
+            return mark_.column;
+        }
+
+    private:
+        /**
+         * @brief   写入内容，不计算位置
+         * @param   data    内容
+         * @param   size    长度
+         * @return  void
+         */
+        void append(const char *data, size_t size)
+        {
+            if (size > static_cast<size_t>(end_ - cur_)) {
+                spill(data, size);
+            } else if (size > 0) {
+                std::memcpy(cur_, data, size);
+                cur_ += size;
+            }
+        }
+
+        /**
+         * @brief   缓冲区剩余空间不足时写入内容
+         * @param   data    内容
+         * @param   size    长度
+         * @return  void
+         */
+        void spill(const char *data, size_t size);
+
+        /**
+         * @brief   直接写入输出目标，不经过缓冲区
+         * @param   data    内容
+         * @param   size    长度
+         * @return  void
+         */
+        void write_target(const char *data, size_t size);
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_OUTPUT_H
@@ -0,0 +1,184 @@
+/**
+ * @file        path_handler.h
+ * @brief       在事件流中匹配路径
+ * @details     继承 Event_Handler，只为匹配路径的子树构建节点
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_PATH_HANDLER_H
+#define CYAML_PATH_HANDLER_H
+
+#include "cyaml/event/event.h"
+#include "cyaml/parser/node_builder.h"
+#include "cyaml/type/node/path.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @class   Path_Handler
+     * @brief   在解析事件流中查找选中的节点
+     * @details 只为匹配的子树构建节点，其余事件直接丢弃，
+     *          不可能匹配的子树整体跳过；
+     *          匹配节点的子孙节点不会再单独匹配；
+     *          匹配子树中的别名只能引用同样被构建的锚点
+     */
+    class Path_Handler: public Event_Handler
+    {
+    public:
+        using Location = Selector::Location;
+
+        /**
+         * @brief   匹配回调
+         * @param   location    匹配节点的位置，只在回调期间有效
+         * @param   node        匹配的节点
+         */
+        using Callback = std::function<
+                void(const Location &location, const Node &node)>;
+
+    private:
+        /**
+         * @struct  Frame
+         * @brief   正在遍历的集合
+         */
+        struct Frame
+        {
+            bool is_map;
+            bool key_turn = true;   // map 的下一个节点是否为键
+            bool key_valid = false; // 当前键是否为标量
+            std::string key;        // 当前键
+            int64_t index = 0;      // sequence 当前元素下标
+        };
+
+        Selector selector_;
+        Callback callback_;
+        Node_Builder builder_;
+
+        std::vector<Frame> frames_; // 从根节点到当前位置的集合
+        Location location_;         // 当前位置
+
+        uint32_t capture_ = 0;  // 正在构建的集合层数
+        uint32_t skip_ = 0;     // 正在跳过的集合层数
+        bool skip_key_ = false; // 正在跳过的是否为集合键
+
+    public:
+        /**
+         * @brief   Path_Handler 类构造函数
+         * @param   selector    选择条件，可以是单个路径
+         * @param   callback    匹配回调
+         * @param   resource    构建节点使用的内存资源
+         */
+        Path_Handler(
+                Selector selector,
+                Callback callback,
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource());
+        ~Path_Handler() override = default;
+
+        // events derived from Event_Handler
+        void on_document_start(const Mark &mark) override;
+
+        void on_document_end() override;
+
+        void on_map_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override;
+
+        void on_map_end() override;
+
+        void on_seq_start(
+                const Mark &mark,
+                std::string anchor,
+                Node_Style style) override;
+
+        void on_seq_end() override;
+
+        void on_scalar(const Mark &mark, std::string anchor, std::string value)
+                override;
+
+        void on_null(const Mark &mark, std::string anchor) override;
+
+        void on_anchor(const Mark &mark, std::string anchor) override{};
+
+        void on_alias(const Mark &mark, std::string anchor) override;
+
+    protected:
+        /**
+         * @brief   判断位置是否匹配
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        virtual bool match(const Location &location) const
+        {
+            return selector_.match(location);
+        }
+
+        /**
+         * @brief   判断位置的子孙节点是否可能匹配
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        virtual bool prefix(const Location &location) const
+        {
+            return selector_.prefix(location);
+        }
+
+    private:
+        /**
+         * @brief   判断下一个节点是否为 map 的键
+         * @return  bool
+         */
+        bool in_key() const
+        {
+            return !frames_.empty() && frames_.back().is_map &&
+                   frames_.back().key_turn;
+        }
+
+        /**
+         * @brief   计算当前位置
+         * @return  const Location &
+         */
+        const Location &location();
+
+        /**
+         * @brief   处理集合开始事件
+         * @param   is_map  是否为 map
+         * @return  bool
+         * @retval  true:   集合需要构建
+         */
+        bool begin_collection(bool is_map);
+
+        /**
+         * @brief   处理集合结束事件
+         * @return  bool
+         * @retval  true:   集合需要构建
+         */
+        bool end_collection();
+
+        /**
+         * @brief   处理标量、空值和别名事件
+         * @param   key     标量值，不是标量时为空指针
+         * @return  bool
+         * @retval  true:   节点需要构建
+         */
+        bool scalar_node(std::string *key);
+
+        /**
+         * @brief   当前节点结束，移动到下一个位置
+         * @return  void
+         */
+        void next();
+
+        /**
+         * @brief   当前节点构建完成，调用回调
+         * @return  void
+         */
+        void deliver();
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_PATH_HANDLER_H
@@ -0,0 +1,84 @@
+/**
+ * @file        scalar_style.h
+ * @brief       输出标量时选择引号和转义
+ * @details     主要包含标量输出风格的判断和带转义的输出函数
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_SCALAR_STYLE_H
+#define CYAML_SCALAR_STYLE_H
+
+#include "cyaml/parser/output.h"
+#include <string_view>
+
+namespace cyaml
+{
+    /**
+     * @enum    Scalar_Style
+     * @brief   标量输出风格
+     */
+    enum class Scalar_Style
+    {
+        PLAIN,         // 原样输出
+        SINGLE_QUOTED, // 单引号，不需要转义
+        DOUBLE_QUOTED, // 双引号，转义特殊字符
+        LITERAL        // 块字面量，保留换行
+    };
+
+    /**
+     * @enum    Scalar_Context
+     * @brief   标量所在的位置
+     */
+    enum class Scalar_Context
+    {
+        BLOCK, // 块集合中的值或根节点
+        KEY,   // 块 map 的键
+        FLOW   // 流式集合中
+    };
+
+    /**
+     * @brief   判断标量的输出风格
+     * @details 每次检查 8 个字节，跳过不含特殊字符的部分，
+     *          只对可能有影响的字符逐个判断；
+     *          与空值混淆的标量保持双引号，多行文本在块集合中
+     *          能够原样保留时使用块字面量，其余需要加引号时
+     *          优先使用单引号
+     * @param   str         标量
+     * @param   context     标量所在的位置
+     * @return  Scalar_Style
+     */
+    Scalar_Style classify_scalar(std::string_view str, Scalar_Context context);
+
+    /**
+     * @brief   按判断出的风格输出 YAML 标量
+     * @param   out         输出
+     * @param   str         标量
+     * @param   context     标量所在的位置
+     * @param   indent      块字面量内容的缩进
+     * @param   raw         是否不计算行列，块字面量需要计算
+     * @return  void
+     */
+    void write_scalar(
+            Output &out,
+            std::string_view str,
+            Scalar_Context context,
+            uint32_t indent,
+            bool raw = false);
+
+    /**
+     * @brief   输出双引号字符串，不需要转义的部分整段写入
+     * @param   out     输出
+     * @param   str     字符串
+     * @param   json    是否按 JSON 转义，否则按 YAML 转义
+     * @param   raw     是否不计算行列
+     * @return  void
+     */
+    void write_double_quoted(
+            Output &out,
+            std::string_view str,
+            bool json,
+            bool raw = false);
+
+} // namespace cyaml
+
+#endif // CYAML_SCALAR_STYLE_H
@@ -8,41 +8,157 @@
 #ifndef CYAML_SERIALIZER_H
 #define CYAML_SERIALIZER_H
 
+#include "cyaml/parser/output.h"
+#include "cyaml/parser/scalar_style.h"
 #include "cyaml/type/node/node.h"
-#include "cyaml/type/mark.h"
 #include <ostream>
 #include <string>
 
 namespace cyaml
 {
+    /**
+     * @enum    Dump_Format
+     * @brief   输出格式
+     */
+    enum class Dump_Format
+    {
+        YAML, // 按节点风格输出块或流式集合
+        FLOW, // 单行流式集合，元素之间不加空格
+        JSON  // 严格 JSON，标量按 core schema 输出数字、布尔值和字符串
+    };
+
     /**
      * @class   Serializer
      * @brief   用于序列化和输出 Node
+     * @details 输出先写入内部缓冲区，serialize() 结束时整块写出；
+     *          FLOW 和 JSON 格式不需要缩进，输出时不计算行列；
+     *          正在输出的集合记录在显式的栈中而不是递归调用，
+     *          嵌套层数只受 max_depth 限制
      */
     class Serializer
     {
+    public:
+        static constexpr uint32_t DEFAULT_MAX_DEPTH = 10000; // 默认最大嵌套层数
+
     private:
-        std::ostream &output_stream_; // 输出流
-        uint32_t indent_inc_ = 2;     // 每级缩进长度
-        Mark mark_{1, 1};             // 当前输出位置
+        enum class Frame_Kind : uint8_t;
+        struct Frame;
+        class Frame_Stack;
+
+        Output output_;                         // 输出
+        Dump_Format format_;                    // 输出格式
+        uint32_t indent_inc_ = 2;               // 每级缩进长度
+        uint32_t max_depth_ = DEFAULT_MAX_DEPTH; // 最大嵌套层数
 
     public:
-        Serializer(std::ostream &out);
+        /**
+         * @brief   输出到输出流
+         * @param   out     输出流
+         * @param   format  输出格式
+         */
+        Serializer(std::ostream &out, Dump_Format format = Dump_Format::YAML);
+
+        /**
+         * @brief   输出到文件描述符
+         * @param   fd      文件描述符
+         * @param   format  输出格式
+         */
+        Serializer(int fd, Dump_Format format = Dump_Format::YAML);
+
+        /**
+         * @brief   追加到字符串
+         * @param   out     字符串
+         * @param   format  输出格式
+         */
+        Serializer(std::string &out, Dump_Format format = Dump_Format::YAML);
+
+        /**
+         * @brief   直接写入调用者提供的内存
+         * @details buffer 为空且容量为 0 时只计算输出长度
+         * @param   buffer      内存
+         * @param   capacity    容量，超出的部分不写入
+         * @param   format      输出格式
+         */
+        Serializer(
+                char *buffer,
+                size_t capacity,
+                Dump_Format format = Dump_Format::YAML);
 
         /**
          * @brief   序列化并输出 node
          * @param   node    节点
          * @return  void
+         * @throw   Representation_Exception    JSON 格式中 map 的键是集合，
+         *                                      或嵌套层数超过限制
          */
         void serialize(const Node &node);
 
+        /**
+         * @brief   多线程序列化并输出 node，输出与 serialize() 完全相同
+         * @details 根集合的条目按顺序分成若干段，由多个线程分别输出到
+         *          各自的字符串后按顺序写出；
+         *          只有冻结的节点树可以被多个线程同时读取，
+         *          未冻结、不是集合或条目过少时按单线程输出
+         * @param   node    节点
+         * @param   threads 线程数，为 0 时使用硬件线程数
+         * @return  void
+         * @throw   Representation_Exception    JSON 格式中 map 的键是集合，
+         *                                      或嵌套层数超过限制
+         */
+        void serialize_parallel(const Node &node, size_t threads = 0);
+
+        /**
+         * @brief   保留源数据的格式输出延迟加载的节点树
+         * @details 未修改的条目从源数据中整段复制，其中的注释、空行、
+         *          引号和缩进保持不变，修改过的子集合只重新输出修改的条目；
+         *          修改或新增的条目按 YAML 格式输出，被修改条目之后的整行
+         *          注释和空行保留，同一行中的注释不保留；
+         *          只构建过的集合需要遍历，尚未构建的集合直接复制；
+         *          节点不是 load_lazy() 加载的根节点，或者格式不是 YAML 时
+         *          与 serialize() 相同
+         * @param   node    节点
+         * @return  void
+         * @throw   Representation_Exception    嵌套层数超过限制
+         */
+        void serialize_preserved(const Node &node);
+
+        /**
+         * @brief   设置最大嵌套层数
+         * @details 集合的嵌套层数超过限制时抛出异常，
+         *          引用形成环的节点树也会因此停止输出
+         * @param   depth   最大嵌套层数
+         * @return  void
+         */
+        void set_max_depth(uint32_t depth)
+        {
+            max_depth_ = depth;
+        }
+
+        /**
+         * @brief   获取最大嵌套层数
+         * @return  uint32_t
+         */
+        uint32_t max_depth() const
+        {
+            return max_depth_;
+        }
+
+        /**
+         * @brief   获取已输出的总长度，包括超出内存容量未写入的部分
+         * @return  size_t
+         */
+        size_t size() const
+        {
+            return output_.size();
+        }
+
         /**
          * @brief   获取当前行
          * @return  uint32_t
          */
         uint32_t line() const
         {
-            return mark_.line;
+            return output_.line();
         }
 
         /**
@@ -51,7 +167,7 @@ namespace cyaml
          */
         uint32_t column() const
         {
-            return mark_.column;
+            return output_.column();
         }
 
     private:
@@ -83,35 +199,174 @@ namespace cyaml
         }
 
         /**
-         * @brief   写入字符串
-         * @param   str     写入内容
+         * @brief   写入标量，按内容选择引号、转义或块字面量
+         * @param   node    标量节点
+         * @param   context 标量所在的位置
+         * @param   indent  块字面量内容的缩进
+         * @return  void
+         */
+        void write_scalar(
+                const Node &node,
+                Scalar_Context context,
+                uint32_t indent);
+
+        /**
+         * @brief   输出集合中的一段条目，包括条目之间的分隔符
+         * @param   node    集合节点
+         * @param   first   第一个条目
+         * @param   last    最后一个条目之后
+         * @param   leading 第一个条目是否为集合的第一个条目
+         * @param   flow    是否以流式输出
+         * @param   indent  块集合的缩进
          * @return  void
          */
-        void write(std::string str);
+        void write_entries(
+                const Node &node,
+                Node::const_iterator first,
+                Node::const_iterator last,
+                bool leading,
+                bool flow,
+                uint32_t indent);
 
         /**
-         * @brief   写入指定个数空格
-         * @param   count   空格个数
+         * @brief   依次输出栈中集合的条目，直到栈为空
+         * @param   stack   正在输出的集合
          * @return  void
          */
-        void write_space(int count = 1);
+        void write_frames(Frame_Stack &stack);
 
         /**
-         * @brief   写入指定个数换行
-         * @param   count   换行个数
+         * @brief   输出栈顶块集合的条目
+         * @details 子节点是块集合时继续输出子节点，
+         *          栈顶变为流式集合或栈为空时返回
+         * @param   stack   正在输出的集合
          * @return  void
          */
-        void write_new_line(int count = 1);
+        void write_block_entries(Frame_Stack &stack);
 
-        void write_node(const Node &node, uint32_t indent);
-        void write_block_node(const Node &node, uint32_t indent);
-        void write_flow_node(const Node &node);
-        void write_block_map(const Node &node, uint32_t indent);
-        void write_block_seq(const Node &node, uint32_t indent);
-        void write_flow_map(const Node &node);
-        void write_flow_seq(const Node &node);
-        void write_key(const Node &node, uint32_t indent);
-        void write_value(const Node &node, uint32_t indent);
+        /**
+         * @brief   输出栈顶流式集合的条目
+         * @details 子节点是集合时继续输出子节点，
+         *          回到块集合或栈为空时返回
+         * @param   stack   正在输出的集合
+         * @return  void
+         */
+        void write_flow_entries(Frame_Stack &stack);
+
+        /**
+         * @brief   输出空值或标量节点
+         * @param   node    节点
+         * @param   kind    所在集合的输出方式
+         * @param   indent  块字面量的缩进
+         * @return  void
+         */
+        void write_leaf(const Node &node, Frame_Kind kind, uint32_t indent);
+
+        /**
+         * @brief   直接输出只包含标量的集合，不入栈
+         * @details 大多数集合位于最内层，省去入栈、出栈和切换集合的开销；
+         *          输出与入栈后由 write_frames() 输出完全相同
+         * @param   stack   正在输出的集合
+         * @param   node    集合节点
+         * @param   kind    所在集合的输出方式
+         * @param   indent  块集合的缩进
+         * @return  bool
+         * @retval  false:  集合包含集合或是空的块集合，没有输出
+         * @throw   Representation_Exception    嵌套层数超过限制
+         */
+        bool write_flat(
+                const Frame_Stack &stack,
+                const Node &node,
+                Frame_Kind kind,
+                uint32_t indent);
+
+        /**
+         * @brief   输出集合的开头并入栈，条目由 write_frames() 输出
+         * @param   stack   正在输出的集合
+         * @param   node    集合节点
+         * @param   kind    所在集合的输出方式
+         * @param   indent  块集合的缩进
+         * @return  void
+         * @throw   Representation_Exception    嵌套层数超过限制
+         */
+        void push_collection(
+                Frame_Stack &stack,
+                const Node &node,
+                Frame_Kind kind,
+                uint32_t indent);
+
+        /**
+         * @brief   集合子节点输出完成后输出后缀，并继续所在集合
+         * @param   frame   所在集合
+         * @param   flow    子节点是否以流式输出
+         * @return  void
+         */
+        void end_child(Frame &frame, bool flow);
+
+        /**
+         * @brief   换行或填充空白到块集合条目的开始位置
+         * @param   target  条目的列号
+         * @return  void
+         */
+        void move_to(uint32_t target);
+
+        /**
+         * @brief   复制源数据中的一段内容
+         * @param   range   源数据中的范围
+         * @param   begin   起始偏移
+         * @param   end     结束偏移
+         * @return  void
+         */
+        void write_source(
+                const Lazy_Range &range,
+                uint32_t begin,
+                uint32_t end);
+
+        /**
+         * @brief   保留源数据的格式输出 block 集合的全部条目
+         * @details 集合未修改时条目与源数据一一对应；
+         *          修改过时由子节点记录的条目序号找到源数据中的条目，
+         *          其余条目为新增条目
+         * @param   node    有源数据范围的集合节点
+         * @param   depth   嵌套层数
+         * @return  void
+         * @throw   Representation_Exception    嵌套层数超过限制
+         */
+        void write_preserved(const Node &node, uint32_t depth);
+
+        /**
+         * @brief   获取仍位于源数据中原位置的 block 集合的范围
+         * @param   node    节点
+         * @return  const Lazy_Range *
+         * @retval  nullptr:    节点不是原位置的 block 集合，或没有记录条目
+         */
+        static const Lazy_Range *source_range(const Node &node);
+
+        /**
+         * @brief   判断节点是否与源数据中原位置的内容相同
+         * @details 节点及其所有已构建的子节点都仍是源数据构建的数据，
+         *          且都没有被修改
+         * @param   node    节点
+         * @return  bool
+         */
+        static bool unchanged(const Node &node);
+
+        /**
+         * @brief   以 JSON 格式输出标量
+         * @details 布尔值和有限的数字不加引号，不符合 JSON 数字格式的
+         *          数字按解析出的值重新输出，其余按字符串输出
+         * @param   node    标量节点
+         * @return  void
+         */
+        void write_json_scalar(const Node &node);
+
+        /**
+         * @brief   以 JSON 格式输出 map 的键，空值和标量都按字符串输出
+         * @param   node    键节点
+         * @return  void
+         * @throw   Representation_Exception    键是集合
+         */
+        void write_json_key(const Node &node);
     };
 
 } // namespace cyaml
@@ -0,0 +1,297 @@
+/**
+ * @file        snapshot.h
+ * @brief       节点树的二进制快照
+ * @details     主要包含快照格式定义和 Snapshot_Writer、Snapshot_Reader
+ *              类声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_SNAPSHOT_H
+#define CYAML_SNAPSHOT_H
+
+#include "cyaml/type/node/node.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @struct  Snapshot_Header
+     * @brief   快照文件头
+     * @details 快照由文件头和数据区组成，数据区按 4 字节对齐存放节点记录，
+     *          节点之间通过相对数据区起始位置的偏移引用，根节点位于偏移 0；
+     *          整数按本机字节序存储，字节序不同时拒绝加载
+     */
+    struct Snapshot_Header
+    {
+        char magic[8];       // 魔数 SNAPSHOT_MAGIC
+        uint32_t version;    // 格式版本
+        uint32_t byte_order; // 写入 SNAPSHOT_BYTE_ORDER，用于检查字节序
+        uint64_t size;       // 数据区长度
+        uint64_t checksum;   // 数据区校验和
+        uint32_t flags;      // SNAPSHOT_FROZEN 等标志
+        uint32_t reserved;   // 保留，为 0
+    };
+
+    /**
+     * @struct  Snapshot_Record
+     * @brief   数据区中的节点记录
+     * @details 记录之后紧跟节点内容，按 4 字节对齐：
+     *          标量为 size 字节的字符串；
+     *          sequence 为 size 个元素偏移；
+     *          map 为 size 对键偏移和值偏移，条目较多时之后是键的哈希索引；
+     *          子节点总是位于父节点之后
+     */
+    struct Snapshot_Record
+    {
+        uint8_t type;      // Node_Type
+        uint8_t style;     // Node_Style
+        uint16_t reserved; // 保留，为 0
+        uint32_t size;     // 标量长度或集合元素个数
+    };
+
+    /**
+     * @struct  Snapshot_Slot
+     * @brief   map 哈希索引中的槽
+     * @details 索引按线性探测存放标量键，不是标量的键不在索引中
+     */
+    struct Snapshot_Slot
+    {
+        uint32_t hash;  // 键的哈希
+        uint32_t entry; // 条目序号加 1，为 0 时是空槽
+    };
+
+    constexpr char SNAPSHOT_MAGIC[8] = {
+            'C', 'Y', 'A', 'M', 'L', 'S', 'N', 'P'};
+    constexpr uint32_t SNAPSHOT_VERSION = 2;
+    constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+    constexpr uint32_t SNAPSHOT_FROZEN = 1; // 保存时节点树已冻结
+    constexpr uint32_t SNAPSHOT_INDEX_MIN = 8; // 超过此条目数的 map 带有索引
+
+    /**
+     * @brief   检查快照文件头
+     * @param   data    快照
+     * @param   verify  是否检查数据区校验和
+     * @return  Snapshot_Header
+     * @throw   Parse_Exception     格式错误、版本或字节序不同、
+     *                              校验和不一致
+     */
+    Snapshot_Header read_snapshot_header(std::string_view data, bool verify);
+
+    /**
+     * @brief   计算 map 哈希索引的槽数
+     * @details 不小于条目数两倍的 2 的幂，条目不多时没有索引；
+     *          槽数超出 uint32_t 范围时同样没有索引
+     * @param   size    map 条目数
+     * @return  uint32_t    槽数，为 0 时没有索引
+     */
+    inline uint32_t snapshot_index_capacity(uint32_t size)
+    {
+        if (size <= SNAPSHOT_INDEX_MIN)
+            return 0;
+
+        uint64_t capacity = 1;
+        while (capacity < 2 * uint64_t(size))
+            capacity <<= 1;
+        return capacity > UINT32_MAX ? 0 : static_cast<uint32_t>(capacity);
+    }
+
+    /**
+     * @brief   计算键的哈希
+     * @details 使用 FNV-1a，写入和查找时结果相同，不依赖标准库实现
+     * @param   key     键
+     * @return  uint32_t
+     */
+    inline uint32_t snapshot_key_hash(std::string_view key)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : key) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+    /**
+     * @brief   计算快照数据区的校验和
+     * @details 每次处理 8 个字节，用于发现文件损坏，不能防止篡改
+     * @param   data    数据
+     * @param   size    长度
+     * @return  uint64_t
+     */
+    uint64_t snapshot_checksum(const char *data, size_t size);
+
+    /**
+     * @class   Snapshot_Writer
+     * @brief   把节点树写为二进制快照
+     * @details 别名引用的节点按值展开，与输出 YAML 时相同；
+     *          正在写入的集合记录在显式的栈中而不是递归调用，
+     *          嵌套层数只受 max_depth 限制
+     */
+    class Snapshot_Writer
+    {
+    public:
+        static constexpr uint32_t DEFAULT_MAX_DEPTH = 10000; // 默认最大嵌套层数
+
+    private:
+        struct Frame;
+
+        std::string &out_; // 输出
+        size_t body_ = 0;  // 数据区在输出中的起始位置
+        uint32_t max_depth_ = DEFAULT_MAX_DEPTH; // 最大嵌套层数
+
+    public:
+        /**
+         * @brief   追加到字符串
+         * @param   out     字符串
+         */
+        explicit Snapshot_Writer(std::string &out): out_(out) {}
+
+        /**
+         * @brief   写入文件头和 node 的全部节点
+         * @param   node    根节点
+         * @return  void
+         * @throw   Representation_Exception    数据区超过 4 GiB，
+         *                                      或嵌套层数超过限制
+         */
+        void write(const Node &node);
+
+        /**
+         * @brief   设置最大嵌套层数
+         * @details 引用形成环的节点树也会因此停止写入
+         * @param   depth   最大嵌套层数
+         * @return  void
+         */
+        void set_max_depth(uint32_t depth)
+        {
+            max_depth_ = depth;
+        }
+
+    private:
+        /**
+         * @brief   写入节点树，子节点写入后回填到父节点记录中的偏移
+         * @param   node    根节点
+         * @return  void
+         */
+        void write_tree(const Node &node);
+
+        /**
+         * @brief   写入一个节点记录，集合预留子节点偏移和索引后入栈
+         * @param   node    节点
+         * @param   stack   正在写入的集合
+         * @return  uint32_t    节点记录的偏移
+         */
+        uint32_t write_node(const Node &node, std::vector<Frame> &stack);
+
+        /**
+         * @brief   把标量键加入 map 的哈希索引
+         * @param   index       索引在输出中的位置
+         * @param   capacity    槽数
+         * @param   key         键
+         * @param   entry       条目序号
+         * @return  void
+         */
+        void index_key(
+                size_t index,
+                uint32_t capacity,
+                std::string_view key,
+                uint32_t entry);
+
+        /**
+         * @brief   在输出末尾预留空间
+         * @param   size    长度，按 4 字节对齐
+         * @return  size_t  预留空间在输出中的位置
+         */
+        size_t reserve(size_t size);
+    };
+
+    /**
+     * @class   Snapshot_Reader
+     * @brief   从二进制快照重建节点树
+     * @details 构造时检查文件头和校验和，构建时检查每个偏移的范围，
+     *          子节点必须位于父节点之后，损坏的快照不会越界读取或形成环；
+     *          正在构建的集合记录在显式的栈中，嵌套层数只受 max_depth 限制
+     */
+    class Snapshot_Reader
+    {
+    public:
+        static constexpr uint32_t DEFAULT_MAX_DEPTH = 10000; // 默认最大嵌套层数
+
+    private:
+        struct Frame;
+
+        const char *body_; // 数据区
+        size_t size_;      // 数据区长度
+        uint32_t flags_;   // 文件头中的标志
+        uint32_t max_depth_ = DEFAULT_MAX_DEPTH; // 最大嵌套层数
+
+        std::pmr::memory_resource *resource_; // 节点内存资源
+
+    public:
+        /**
+         * @brief   检查快照的文件头和校验和
+         * @param   data        快照，需要在读取期间有效
+         * @param   resource    节点内存资源
+         * @throw   Parse_Exception     格式错误、版本或字节序不同、
+         *                              校验和不一致
+         */
+        Snapshot_Reader(
+                std::string_view data,
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource());
+
+        /**
+         * @brief   构建根节点，保存时已冻结的节点树在构建后冻结
+         * @return  Node
+         * @throw   Parse_Exception     节点记录错误，或嵌套层数超过限制
+         */
+        Node root();
+
+        /**
+         * @brief   设置最大嵌套层数
+         * @param   depth   最大嵌套层数
+         * @return  void
+         */
+        void set_max_depth(uint32_t depth)
+        {
+            max_depth_ = depth;
+        }
+
+    private:
+        /**
+         * @brief   构建节点树
+         * @param   offset  根节点记录的偏移
+         * @return  Node_Ptr
+         */
+        Node_Ptr build(uint32_t offset);
+
+        /**
+         * @brief   构建一个节点，有子节点的集合预留空间后入栈
+         * @param   offset  节点记录的偏移
+         * @param   stack   正在构建的集合
+         * @return  Node_Ptr
+         */
+        Node_Ptr build_node(uint32_t offset, std::vector<Frame> &stack);
+
+        /**
+         * @brief   读取子节点偏移，检查是否位于父节点之后
+         * @param   pos     偏移所在位置
+         * @param   parent  父节点记录的偏移
+         * @return  uint32_t
+         */
+        uint32_t child(size_t pos, uint32_t parent) const;
+
+        /**
+         * @brief   检查数据区中的范围
+         * @param   offset  起始偏移
+         * @param   size    长度
+         * @return  void
+         */
+        void check(size_t offset, size_t size) const;
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_SNAPSHOT_H
@@ -16,6 +16,7 @@ namespace cyaml
     {
         uint32_t line = 0;
         uint32_t column = 0;
+        uint32_t offset = 0; // 从输入开始的 utf-8 字节偏移
 
         Mark() = default;
         Mark(const Mark &) = default;
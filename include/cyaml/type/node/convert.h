@@ -11,6 +11,10 @@
 #include "cyaml/type/node/node.h"
 #include <string>
 #include <iostream>
+#include <limits>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
 #include <assert.h>
 
 namespace cyaml
@@ -89,36 +93,208 @@ namespace cyaml
         }
     };
 
-    // int
-    template<>
-    struct Converter<int>
+    /**
+     * @struct  Integral_Converter
+     * @brief   整数类型转换
+     * @details 基于 std::from_chars/std::to_chars，不受 locale 影响；
+     *          非整数或超出目标类型范围时抛出 Convertion_Exception
+     * @tparam  T   整数类型
+     */
+    template<typename T>
+    struct Integral_Converter
     {
-        static Node encode(const int &rhs)
+        static Node encode(const T &rhs)
         {
-            return Node(std::to_string(rhs));
+            char buf[std::numeric_limits<T>::digits10 + 3];
+            auto result = std::to_chars(buf, buf + sizeof(buf), rhs);
+            assert(result.ec == std::errc());
+            return Node(std::string(buf, result.ptr));
         }
 
-        static int decode(const Node &node)
+        static T decode(const Node &node)
         {
-            return std::stoi(node.scalar());
+            if (!node.is_scalar())
+                throw Convertion_Exception();
+
+            const auto &value = node.resolve();
+            if (value.type == Scalar_Type::INT) {
+                if constexpr (std::is_signed_v<T>) {
+                    if (value.integer >= std::numeric_limits<T>::min() &&
+                        value.integer <= std::numeric_limits<T>::max()) {
+                        return static_cast<T>(value.integer);
+                    }
+                } else {
+                    if (value.integer >= 0 &&
+                        static_cast<uint64_t>(value.integer) <=
+                                std::numeric_limits<T>::max()) {
+                        return static_cast<T>(value.integer);
+                    }
+                }
+
+                throw Convertion_Exception();
+            }
+
+            // 超出 int64 范围的无符号整数无法缓存，直接解析
+            if constexpr (!std::is_signed_v<T>) {
+                auto str = node.scalar_view();
+                T ret = 0;
+                auto [ptr, ec] = std::from_chars(
+                        str.data(), str.data() + str.size(), ret);
+                if (!str.empty() && ec == std::errc() &&
+                    ptr == str.data() + str.size()) {
+                    return ret;
+                }
+            }
+
+            throw Convertion_Exception();
         }
     };
 
-    // float
-    template<>
-    struct Converter<float>
+    /**
+     * @struct  Floating_Converter
+     * @brief   浮点类型转换
+     * @details 输出最短的可精确还原的十进制表示，
+     *          无穷大和 NaN 按 YAML 写作 .inf、-.inf、.nan；
+     *          有限值超出目标类型范围时抛出 Convertion_Exception，
+     *          超出 double 范围的标量按无穷大或 0 解析
+     * @tparam  T   浮点类型
+     */
+    template<typename T>
+    struct Floating_Converter
     {
-        static Node encode(const float &rhs)
+        static Node encode(const T &rhs)
         {
-            return Node(std::to_string(rhs));
+            if (std::isnan(rhs))
+                return Node(".nan");
+
+            if (std::isinf(rhs))
+                return Node(rhs > 0 ? ".inf" : "-.inf");
+
+            char buf[64];
+            auto result = std::to_chars(buf, buf + sizeof(buf), rhs);
+            assert(result.ec == std::errc());
+
+            // 保证输出仍被解析为浮点数
+            std::string ret(buf, result.ptr);
+            if (ret.find_first_of(".e") == std::string::npos) {
+                ret += ".0";
+            }
+
+            return Node(ret);
         }
 
-        static float decode(const Node &node)
+        static T decode(const Node &node)
         {
-            return std::stof(node.scalar());
+            if (!node.is_scalar())
+                throw Convertion_Exception();
+
+            const auto &value = node.resolve();
+            if (value.type == Scalar_Type::INT)
+                return static_cast<T>(value.integer);
+
+            if (value.type != Scalar_Type::FLOAT)
+                throw Convertion_Exception();
+
+            // 缓存为 double，long double 需要重新解析以保留精度和范围
+            if constexpr (sizeof(T) > sizeof(double)) {
+                auto str = node.scalar_view();
+                if (str[0] == '+' || str[0] == '-')
+                    str.remove_prefix(1);
+
+                // .inf 和 .nan 使用缓存
+                if (str[0] != '.' || (str.size() > 1 && str[1] <= '9')) {
+                    T ret = 0;
+                    auto [ptr, ec] = std::from_chars(
+                            str.data(), str.data() + str.size(), ret);
+                    if (ptr != str.data() + str.size())
+                        throw Convertion_Exception();
+
+                    // 超出 long double 范围时同样超出 double 范围
+                    if (ec == std::errc::result_out_of_range)
+                        return static_cast<T>(value.real);
+                    if (ec != std::errc())
+                        throw Convertion_Exception();
+
+                    return std::signbit(value.real) ? -ret : ret;
+                }
+            }
+
+            // 有限值缩小为 float 时不能变为无穷大
+            T ret = static_cast<T>(value.real);
+            if (std::isinf(ret) && std::isfinite(value.real))
+                throw Convertion_Exception();
+
+            return ret;
         }
     };
 
+    template<>
+    struct Converter<signed char>: Integral_Converter<signed char>
+    {
+    };
+
+    template<>
+    struct Converter<unsigned char>: Integral_Converter<unsigned char>
+    {
+    };
+
+    template<>
+    struct Converter<short>: Integral_Converter<short>
+    {
+    };
+
+    template<>
+    struct Converter<unsigned short>: Integral_Converter<unsigned short>
+    {
+    };
+
+    template<>
+    struct Converter<int>: Integral_Converter<int>
+    {
+    };
+
+    template<>
+    struct Converter<unsigned int>: Integral_Converter<unsigned int>
+    {
+    };
+
+    template<>
+    struct Converter<long>: Integral_Converter<long>
+    {
+    };
+
+    template<>
+    struct Converter<unsigned long>: Integral_Converter<unsigned long>
+    {
+    };
+
+    template<>
+    struct Converter<long long>: Integral_Converter<long long>
+    {
+    };
+
+    template<>
+    struct Converter<unsigned long long>
+        : Integral_Converter<unsigned long long>
+    {
+    };
+
+    template<>
+    struct Converter<float>: Floating_Converter<float>
+    {
+    };
+
+    template<>
+    struct Converter<double>: Floating_Converter<double>
+    {
+    };
+
+    template<>
+    struct Converter<long double>: Floating_Converter<long double>
+    {
+    };
+
+    // bool
     template<>
     struct Converter<bool>
     {
@@ -135,11 +311,11 @@ namespace cyaml
             if (!node.is_scalar())
                 throw Convertion_Exception();
 
-            std::string value = node.scalar();
-            if (value != "true" && value != "false")
+            const auto &value = node.resolve();
+            if (value.type != Scalar_Type::BOOL)
                 throw Convertion_Exception();
 
-            return value == "true";
+            return value.boolean;
         }
     };
 
@@ -0,0 +1,160 @@
+/**
+ * @file        iterator.h
+ * @brief       节点迭代器
+ * @details     提供遍历 map 键值对和 sequence 元素的迭代器，
+ *              迭代过程直接访问节点数据，不复制节点
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_ITERATOR_H
+#define CYAML_ITERATOR_H
+
+#include "cyaml/type/node/node_data.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace cyaml
+{
+    /**
+     * @struct  Node_Entry
+     * @brief   迭代器解引用结果
+     * @details 遍历 map 时 first 为键，second 为值；
+     *          遍历 sequence 时 first 和 second 均为元素。
+     *          支持结构化绑定 auto [key, value]，
+     *          也可以隐式转换为元素引用 Node &
+     * @tparam  V   值节点类型，Node 或 const Node
+     */
+    template<typename V>
+    struct Node_Entry
+    {
+        const Node &first;
+        V &second;
+
+        operator V &() const
+        {
+            return second;
+        }
+    };
+
+    /**
+     * @class   Node_Iterator
+     * @brief   map 和 sequence 的双向迭代器
+     * @details 插入或删除元素后迭代器失效
+     * @tparam  V   值节点类型，Node 或 const Node
+     */
+    template<typename V>
+    class Node_Iterator
+    {
+    private:
+        const KV_Pair *pair_ = nullptr;  // 当前键值对，遍历 map 时使用
+        const Node_Ptr *elem_ = nullptr; // 当前元素，遍历 sequence 时使用
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Node_Entry<V>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Node_Entry<V>;
+
+        Node_Iterator() = default;
+
+        explicit Node_Iterator(const KV_Pair *pair): pair_(pair) {}
+
+        explicit Node_Iterator(const Node_Ptr *elem): elem_(elem) {}
+
+        /**
+         * @brief   由非 const 迭代器转换为 const 迭代器
+         */
+        template<
+                typename U,
+                typename = std::enable_if_t<
+                        std::is_const_v<V> && !std::is_const_v<U>>>
+        Node_Iterator(const Node_Iterator<U> &other)
+            : pair_(other.pair()),
+              elem_(other.elem())
+        {
+        }
+
+        reference operator*() const
+        {
+            if (pair_)
+                return {*pair_->first, *pair_->second};
+
+            return {**elem_, **elem_};
+        }
+
+        /**
+         * @brief   获取键，仅遍历 map 时可用
+         * @return  const Node &
+         */
+        const Node &key() const
+        {
+            return *pair_->first;
+        }
+
+        /**
+         * @brief   获取值或元素
+         * @return  V &
+         */
+        V &value() const
+        {
+            return pair_ ? *pair_->second : **elem_;
+        }
+
+        Node_Iterator &operator++()
+        {
+            if (pair_)
+                ++pair_;
+            else
+                ++elem_;
+            return *this;
+        }
+
+        Node_Iterator operator++(int)
+        {
+            Node_Iterator ret = *this;
+            ++(*this);
+            return ret;
+        }
+
+        Node_Iterator &operator--()
+        {
+            if (pair_)
+                --pair_;
+            else
+                --elem_;
+            return *this;
+        }
+
+        Node_Iterator operator--(int)
+        {
+            Node_Iterator ret = *this;
+            --(*this);
+            return ret;
+        }
+
+        bool operator==(const Node_Iterator &rhs) const
+        {
+            return pair_ == rhs.pair_ && elem_ == rhs.elem_;
+        }
+
+        bool operator!=(const Node_Iterator &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        const KV_Pair *pair() const
+        {
+            return pair_;
+        }
+
+        const Node_Ptr *elem() const
+        {
+            return elem_;
+        }
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_ITERATOR_H
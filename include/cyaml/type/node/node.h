@@ -9,6 +9,7 @@
 #define CYAML_VALUE_H
 
 #include "cyaml/type/node/node_data.h"
+#include "cyaml/type/node/iterator.h"
 #include "cyaml/error/exceptions.h"
 
 namespace cyaml
@@ -17,7 +18,7 @@ namespace cyaml
      * @enum    Node_Type
      * @brief   声明节点的数据类型
      */
-    enum class Node_Type
+    enum class Node_Type : uint8_t
     {
         NONE, // null
         MAP,
@@ -29,7 +30,7 @@ namespace cyaml
      * @enum    Node_Style
      * @brief   节点样式
      */
-    enum class Node_Style
+    enum class Node_Style : uint8_t
     {
         BLOCK,
         FLOW
@@ -42,16 +43,24 @@ namespace cyaml
     class Node: public std::enable_shared_from_this<Node>
     {
     private:
-        Node_Type type_;     // 节点类型
-        Node_Data_Ptr data_; // 节点数据
+        Node_Data_Ptr data_;          // 节点数据
+        Node_Data *parent_ = nullptr; // 所在集合的数据，用于使哈希缓存失效
+        Node_Type type_;              // 节点类型
 
         Node_Style style_ = Node_Style::BLOCK; // 节点样式
 
+        bool frozen_ = false; // 是否为冻结节点树中的节点
+
     public:
-        Node(Node_Type type = Node_Type::NONE);
+        Node(Node_Type type = Node_Type::NONE,
+             std::pmr::memory_resource *resource =
+                     std::pmr::get_default_resource());
         Node(const Node &node);
+        Node(Node &&node);
         Node(const Node_Ptr &node);
-        Node(const std::string &scalar);
+        Node(const std::string &scalar,
+             std::pmr::memory_resource *resource =
+                     std::pmr::get_default_resource());
         ~Node();
 
         friend bool operator==(const Node &n1, const Node &n2);
@@ -59,6 +68,15 @@ namespace cyaml
         friend bool operator!=(const Node &n1, const Node &n2);
         friend bool operator!=(const Node_Ptr &n1, const Node_Ptr &n2);
 
+        friend struct Node_Data;
+        friend class Node_Builder;
+        friend class Lazy_Builder;
+        friend class Intern_Table;
+        friend class Key_Table;
+        friend class Usage_Counter;
+        friend class Snapshot_Reader;
+        friend class Serializer;
+
         /**
          * @brief   获取值的类型
          * @return  Node_Type
@@ -84,9 +102,43 @@ namespace cyaml
          */
         void set_style(Node_Style style)
         {
+            if (frozen_)
+                throw Frozen_Exception();
+
+            if (style_ != style)
+                data_->mark_modified();
             style_ = style;
         }
 
+        /**
+         * @brief   冻结节点树
+         * @details 冻结后节点树只读，查找、遍历、取值、复制节点等只读操作
+         *          不会修改任何共享状态，可以被多个线程同时访问；
+         *          修改冻结节点会抛出 Frozen_Exception，
+         *          需要修改时可以先 clone() 得到可修改的副本
+         * @return  void
+         */
+        void freeze();
+
+        /**
+         * @brief   判断节点数据是否已冻结
+         * @return  bool
+         */
+        bool is_frozen() const
+        {
+            return data_->frozen;
+        }
+
+        /**
+         * @brief   获取节点数据使用的 memory_resource
+         * @details 子节点从父节点的 memory_resource 分配
+         * @return  std::pmr::memory_resource *
+         */
+        std::pmr::memory_resource *resource() const
+        {
+            return data_->resource();
+        }
+
         /**
          * @brief   获取数据长度
          * @return  uint32_t
@@ -145,15 +197,70 @@ namespace cyaml
         std::string scalar() const
         {
             assert(data_);
-            return data_->scalar;
+            auto &scalar = body().scalar;
+            return std::string(scalar.data(), scalar.size());
+        }
+
+        /**
+         * @brief   获取标量视图，不复制字符串
+         * @details 返回值在节点数据被修改或销毁前有效
+         * @return  std::string_view
+         */
+        std::string_view scalar_view() const
+        {
+            assert(data_);
+            return body().scalar;
         }
 
+        /**
+         * @brief   获取按 YAML core schema 解析后的标量值
+         * @details 第一次调用时解析并缓存在节点数据中，之后直接返回缓存，
+         *          冻结的节点在冻结时已完成解析；仅对标量有意义
+         * @return  const Scalar_Value &
+         */
+        const Scalar_Value &resolve() const
+        {
+            assert(data_);
+            return body().resolve();
+        }
+
+        /**
+         * @brief   获取结构哈希
+         * @details 相等的节点哈希相同，哈希缓存在节点数据中，
+         *          节点被修改后重新计算；冻结的节点在冻结时完成计算
+         * @return  size_t
+         */
+        size_t hash() const;
+
         /**
          * @brief   获取所有 key
          * @return  std::vector<Node>
          */
         std::vector<Node> keys() const;
 
+        using iterator = Node_Iterator<Node>;
+        using const_iterator = Node_Iterator<const Node>;
+
+        /**
+         * @brief   获取指向第一个元素的迭代器
+         * @details 遍历 map 时解引用得到键值对，可以使用结构化绑定
+         *          for (auto [key, value] : node)；
+         *          遍历 sequence 时解引用结果可以转换为元素引用
+         *          for (Node &elem : node)；
+         *          标量和空值节点没有元素，begin() == end()；
+         *          迭代过程不复制节点，不修改引用计数
+         * @return  iterator
+         */
+        iterator begin();
+        const_iterator begin() const;
+
+        /**
+         * @brief   获取指向最后一个元素之后的迭代器
+         * @return  iterator
+         */
+        iterator end();
+        const_iterator end() const;
+
         /**
          * @brief   获取序列(数组)元素
          * @param   index   元素索引值
@@ -229,6 +336,22 @@ namespace cyaml
          * @retval  false:  节点无法转换为 map，插入失败
          */
         bool insert(const Node &key, const Node &value);
+        bool insert(Node &&key, Node &&value);
+
+        /**
+         * @brief   原地构造并插入键值对
+         * @details 键和值直接在 map 中构造，参数可以是 Node 的构造参数，
+         *          也可以是任意实现了 Converter 的类型
+         * @tparam  K       键类型
+         * @tparam  Args    值构造参数类型
+         * @param   key     键
+         * @param   args    值构造参数
+         * @return  bool
+         * @retval  true:   插入成功
+         * @retval  false:  节点无法转换为 map，插入失败
+         */
+        template<typename K, typename... Args>
+        bool emplace(K &&key, Args &&... args);
 
         /**
          * @brief   数组添加节点
@@ -238,6 +361,17 @@ namespace cyaml
          * @retval  false:  节点无法转换为 seq，添加失败
          */
         bool push_back(const Node &node);
+        bool push_back(Node &&node);
+
+        /**
+         * @brief   在数组指定位置插入节点
+         * @param   index   插入位置，等于元素个数时添加到末尾
+         * @param   node    插入的节点
+         * @return  bool
+         * @retval  true:   插入成功
+         * @retval  false:  节点无法转换为 seq，或索引越界
+         */
+        bool insert(uint32_t index, const Node &node);
 
         /**
          * @brief   数组添加节点
@@ -250,6 +384,26 @@ namespace cyaml
         template<typename T>
         bool push_back(const T &rhs);
 
+        /**
+         * @brief   在数组末尾原地构造节点
+         * @details 参数可以是 Node 的构造参数，也可以是任意实现了 Converter
+         *          的类型
+         * @tparam  Args    构造参数类型
+         * @param   args    构造参数
+         * @return  bool
+         * @retval  true:   添加成功
+         * @retval  false:  节点无法转换为 seq，添加失败
+         */
+        template<typename... Args>
+        bool emplace_back(Args &&... args);
+
+        /**
+         * @brief   预留 map 或 seq 的容量
+         * @param   size    元素个数
+         * @return  void
+         */
+        void reserve(uint32_t size);
+
         /**
          * @brief   删除元素
          * @param   key     键
@@ -259,15 +413,43 @@ namespace cyaml
          */
         bool erase(const Node &key);
 
+        /**
+         * @brief   删除数组元素
+         * @param   index   元素索引值
+         * @return  bool
+         * @retval  true:   删除成功
+         * @retval  false:  节点不是 seq，或索引越界
+         */
+        bool erase(uint32_t index);
+
         /**
          * @brief   克隆节点
-         * @details 用于赋值时传递节点的值而非引用
+         * @details 用于赋值时传递节点的值而非引用；
+         *          克隆冻结的节点时为 O(1)，克隆节点与原节点共享数据，
+         *          直到克隆节点被修改时才复制从根到修改位置的路径；
+         *          克隆未冻结的节点时进行深复制；
+         *          新节点从原节点的内存资源分配，多个线程同时克隆同一棵
+         *          冻结的节点树时，该资源需要是线程安全的
          * @return  Node
          */
         Node clone() const
+        {
+            return clone(resource());
+        }
+
+        /**
+         * @brief   克隆节点到指定的内存资源
+         * @details 新节点及修改时复制的数据都从 resource 分配，
+         *          多个线程可以各自使用自己的资源克隆同一棵冻结的节点树；
+         *          克隆冻结的节点时仍共享原节点树的数据，
+         *          原节点树的内存资源需要比克隆节点存在更久
+         * @param   resource    内存资源
+         * @return  Node
+         */
+        Node clone(std::pmr::memory_resource *resource) const
         {
             Node_Ptr node;
-            clone(node);
+            clone(node, resource);
             return *node;
         }
 
@@ -277,16 +459,65 @@ namespace cyaml
          */
         void clear()
         {
+            check_mutable();
+
             if (is_scalar()) {
                 data_->scalar.clear();
+                data_->value = Scalar_Value();
             } else if (is_map()) {
+                data_->orphan_children();
                 data_->map.clear();
             } else if (is_seq()) {
+                data_->orphan_children();
                 data_->seq.clear();
             }
         }
 
     private:
+        /**
+         * @brief   获取实际存储内容的节点数据
+         * @details 未修改过的克隆节点读取共享的数据
+         * @return  Node_Data &
+         */
+        Node_Data &body() const
+        {
+            if (data_->is_lazy())
+                materialize();
+
+            return data_->source ? *data_->source : *data_;
+        }
+
+        /**
+         * @brief   构建延迟加载的子节点
+         * @details 从源数据中重新解析当前集合，只构建直接子节点
+         * @return  void
+         */
+        void materialize() const;
+
+        /**
+         * @brief   检查节点数据能否修改
+         * @details 节点数据已冻结时抛出 Frozen_Exception，
+         *          共享数据的克隆节点在修改前复制数据，
+         *          并记录数据已被修改，保留格式输出时不再复制源数据
+         * @return  void
+         */
+        void check_mutable()
+        {
+            if (data_->frozen)
+                throw Frozen_Exception();
+
+            detach();
+            data_->mark_modified();
+            data_->invalidate_hash();
+        }
+
+        /**
+         * @brief   复制共享的数据
+         * @details 只复制当前一层，子节点成为共享原数据的克隆节点
+         * @return  void
+         */
+        void detach();
+
         /**
          * @brief   重置节点
          * @param   type    重置节点类型
@@ -294,19 +525,28 @@ namespace cyaml
          */
         void reset(Node_Type type = Node_Type::NONE)
         {
+            // 与赋值相同，冻结数据不能修改时只重新绑定当前节点
+            if (data_->frozen && !frozen_)
+                Node_Data::invalidate_parents(parent_);
+            else
+                check_mutable();
+
             type_ = type;
             if (!is_null()) {
+                auto *resource = data_->resource();
                 data_->remove_ref(this);
-                data_ = std::make_shared<Node_Data>();
+                data_ = make_pmr_shared<Node_Data>(resource, resource);
+                data_->insert_ref(this);
             }
         }
 
         /**
          * @brief   克隆节点内部实现
-         * @param   node    节点指针
+         * @param   node        节点指针
+         * @param   resource    内存资源
          * @return  void
          */
-        void clone(Node_Ptr &node) const;
+        void clone(Node_Ptr &node, std::pmr::memory_resource *resource) const;
 
         /**
          * @brief   查找 map
@@ -314,7 +554,7 @@ namespace cyaml
          * @return  Map::iterator
          * @retval  map.end():  查找失败
          */
-        Map::iterator find(const Node_Ptr &key) const;
+        Map::iterator find(const Node &key) const;
 
         /**
          * @brief   插入键值对
@@ -324,10 +564,33 @@ namespace cyaml
          */
         void insert(const Node_Ptr &key, const Node_Ptr &value)
         {
-            assert(!contain(key));
+            assert(!contain(*key));
+            key->parent_ = value->parent_ = data_.get();
             data_->map.emplace_back(key, value);
+            data_->invalidate_hash();
+        }
+
+        /**
+         * @brief   数组添加节点指针，不复制节点
+         * @param   node    节点指针
+         * @return  void
+         */
+        void append(const Node_Ptr &node)
+        {
+            node->parent_ = data_.get();
+            data_->seq.emplace_back(node);
+            data_->invalidate_hash();
         }
 
+        /**
+         * @brief   使用当前节点的内存资源创建子节点
+         * @tparam  Args    构造参数类型
+         * @param   args    Node 构造参数或需要转换的值
+         * @return  Node_Ptr
+         */
+        template<typename... Args>
+        Node_Ptr make_child(Args &&... args) const;
+
         /**
          * @brief   重置节点指向数据
          * @param   data    节点数据指针
@@ -337,4 +600,16 @@ namespace cyaml
     };
 } // namespace cyaml
 
+namespace std
+{
+    template<>
+    struct hash<cyaml::Node>
+    {
+        size_t operator()(const cyaml::Node &node) const
+        {
+            return node.hash();
+        }
+    };
+} // namespace std
+
 #endif // CYAML_VALUE_H
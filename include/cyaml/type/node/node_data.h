@@ -14,7 +14,9 @@
 #include <vector>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <iostream>
 
 // 类型声明
@@ -28,8 +30,8 @@ namespace cyaml
     using Node_Data_Ptr = std::shared_ptr<Node_Data>;
 
     using KV_Pair = std::pair<Node_Ptr, Node_Ptr>;
-    using Map = std::list<KV_Pair>;
-    using Sequence = std::vector<Node_Ptr>;
+    using Map = std::pmr::vector<KV_Pair>;
+    using Sequence = std::pmr::vector<Node_Ptr>;
 
     class Ref_Hash
     {
@@ -44,27 +46,266 @@ namespace cyaml
 
 namespace cyaml
 {
+    /**
+     * @enum    Scalar_Type
+     * @brief   按 YAML core schema 解析的标量类型
+     */
+    enum class Scalar_Type : uint8_t
+    {
+        UNRESOLVED, // 尚未解析
+        NONE,       // null
+        BOOL,
+        INT,
+        FLOAT,
+        STRING
+    };
+
+    /**
+     * @struct  Scalar_Value
+     * @brief   标量解析结果缓存
+     */
+    struct Scalar_Value
+    {
+        Scalar_Type type = Scalar_Type::UNRESOLVED;
+        union
+        {
+            bool boolean;
+            int64_t integer;
+            double real;
+        };
+
+        Scalar_Value(): integer(0) {}
+    };
+
+    /**
+     * @brief   按 YAML core schema 解析标量
+     * @param   str     标量
+     * @return  Scalar_Value
+     */
+    Scalar_Value resolve_scalar(std::string_view str);
+
+    /**
+     * @brief   合并哈希值
+     * @details Node::hash() 和加载时逐层计算的子树哈希使用相同的合并方式
+     * @param   seed    当前哈希
+     * @param   value   需要合并的哈希
+     * @return  void
+     */
+    inline void hash_combine(size_t &seed, size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    /**
+     * @enum    Hash_State
+     * @brief   结构哈希缓存的状态
+     */
+    enum class Hash_State : uint8_t
+    {
+        STALE,   // 未计算或已失效
+        HASHING, // 正在计算，用于处理锚点形成的环
+        VALID    // 缓存有效
+    };
+
+    /**
+     * @struct  Lazy_Range
+     * @brief   延迟加载的集合在源数据中的范围
+     * @details 集合构建后继续保留，记录每个条目的起始位置，
+     *          用于保留格式输出时直接复制未修改的条目
+     */
+    struct Lazy_Range
+    {
+        std::shared_ptr<const std::string> buffer; // 源数据
+        uint32_t begin;  // 起始字节偏移
+        uint32_t end;    // 结束字节偏移
+        uint32_t column; // 起始位置的列号
+
+        // 各条目第一个字符的偏移，最后一项为最后一个条目的结束偏移
+        std::vector<uint32_t> entries;
+
+        bool root = false; // 是否为文档的根节点
+    };
+
+    /**
+     * @struct  Source_State
+     * @brief   从源数据构建的节点数据的附加状态
+     * @details 用于延迟加载和保留格式输出，只为从源数据构建的节点数据分配，
+     *          其他节点数据只保存一个空指针
+     */
+    struct Source_State
+    {
+        std::shared_ptr<Lazy_Range> lazy; // 尚未构建的子节点在源数据中的范围
+        std::shared_ptr<Lazy_Range> span; // 已构建的子节点在源数据中的范围
+
+        const Node *origin = nullptr; // 从源数据构建该数据时所在的节点
+        uint32_t entry = 0;           // 在所在集合中的条目序号
+        bool modified = false;        // 从源数据构建后是否被修改过
+    };
+
     /**
      * @struct  Node_Data
      * @brief   YAML 数据节点
+     * @details 所有容器均从同一个 memory_resource 分配内存，
+     *          该 resource 的生命周期必须长于节点数据
      */
     struct Node_Data
     {
-        Map map;            // 映射数据
-        Sequence seq;       // 序列数据
-        std::string scalar; // 标量数据
+        Map map;                 // 映射数据
+        Sequence seq;            // 序列数据
+        std::pmr::string scalar; // 标量数据
+
+        std::pmr::unordered_set<Node *> refs; // 引用的节点
+
+        Scalar_Value value; // 标量解析结果缓存，标量修改后需要重置
+
+        Node_Data_Ptr source; // 写时复制的共享数据，只能指向冻结的数据
+
+        // 从源数据构建时的附加状态，从 resource() 分配，其他情况为空
+        Source_State *tracked = nullptr;
+
+        size_t hash = 0; // 结构哈希缓存
+
+        bool frozen = false; // 冻结后数据只读，且不再记录引用
+
+        /**
+         * @brief   结构哈希缓存的状态
+         * @details 数据被修改时失效，并向上使所在集合的缓存失效；
+         *          冻结数据不会再被修改，哈希缓存始终有效
+         */
+        Hash_State hash_state = Hash_State::STALE;
+
+        Node_Data(
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource());
+        Node_Data(
+                const std::string &value,
+                std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource());
+        Node_Data(const Node_Data &) = delete;
+        Node_Data &operator=(const Node_Data &) = delete;
+        ~Node_Data();
 
-        std::unordered_set<Node *> refs; // 引用的节点
+        /**
+         * @brief   获取分配内存使用的 memory_resource
+         * @return  std::pmr::memory_resource *
+         */
+        std::pmr::memory_resource *resource() const
+        {
+            return seq.get_allocator().resource();
+        }
+
+        /**
+         * @brief   按 YAML core schema 解析标量并缓存结果
+         * @return  const Scalar_Value &
+         */
+        const Scalar_Value &resolve();
 
-        Node_Data() = default;
-        Node_Data(std::string value);
-        Node_Data(const Node_Data &) = default;
-        Node_Data &operator=(const Node_Data &) = default;
+        /**
+         * @brief   判断是否有尚未构建的子节点
+         * @return  bool
+         */
+        bool is_lazy() const
+        {
+            return tracked && tracked->lazy;
+        }
+
+        /**
+         * @brief   获取从源数据构建时的附加状态，不存在时创建
+         * @return  Source_State &
+         */
+        Source_State &track();
+
+        /**
+         * @brief   获取节点在构建时的位置上的附加状态
+         * @param   node    节点
+         * @return  Source_State *  不是从源数据构建，或节点已不在原位置时为空
+         */
+        Source_State *source_state(const Node *node) const
+        {
+            return tracked && tracked->origin == node ? tracked : nullptr;
+        }
+
+        /**
+         * @brief   记录数据在构建后被修改过
+         * @return  void
+         */
+        void mark_modified() noexcept
+        {
+            if (tracked)
+                tracked->modified = true;
+        }
+
+        /**
+         * @brief   节点不再位于构建时的位置，清除记录
+         * @param   node    节点
+         * @return  void
+         */
+        void untrack(const Node *node) noexcept
+        {
+            if (tracked && tracked->origin == node)
+                tracked->origin = nullptr;
+        }
+
+        /**
+         * @brief   判断哈希缓存是否有效
+         * @return  bool
+         */
+        bool hash_cached() const
+        {
+            return hash_state == Hash_State::VALID;
+        }
+
+        /**
+         * @brief   数据被修改，使自身和所有包含它的集合的哈希缓存失效
+         * @details 经由引用该数据的节点向上传播，遇到已失效的集合时停止，
+         *          已失效集合的上层集合一定已失效
+         * @return  void
+         */
+        void invalidate_hash() noexcept;
+
+        /**
+         * @brief   清除子节点指向当前集合的记录，在移除全部子节点前调用
+         * @return  void
+         */
+        void orphan_children() noexcept;
+
+        /**
+         * @brief   判断节点是否只被一处持有，且数据中有子节点
+         * @details 这样的节点释放时会继续释放子节点，析构时逐个取出，
+         *          避免深层嵌套的节点树递归释放
+         * @param   node    节点
+         * @return  bool
+         */
+        static bool owns_children(const Node_Ptr &node);
+
+        /**
+         * @brief   使集合及其上层集合的哈希缓存失效
+         * @param   data    集合数据，可以为空
+         * @return  void
+         */
+        static void invalidate_parents(Node_Data *data) noexcept;
 
         void insert_ref(const Node *node);
         void remove_ref(const Node *node);
     };
 
+    /**
+     * @brief   使用指定 memory_resource 创建共享对象
+     * @tparam  T           对象类型
+     * @param   resource    内存资源
+     * @param   args        构造参数
+     * @return  std::shared_ptr<T>
+     */
+    template<typename T, typename... Args>
+    std::shared_ptr<T> make_pmr_shared(
+            std::pmr::memory_resource *resource,
+            Args &&... args)
+    {
+        return std::allocate_shared<T>(
+                std::pmr::polymorphic_allocator<T>(resource),
+                std::forward<Args>(args)...);
+    }
+
 } // namespace cyaml
 
 #endif // CYAML_NODE_H
@@ -11,24 +11,14 @@
 #include "cyaml/type/node/node.h"
 #include "cyaml/type/node/convert.h"
 #include <string>
+#include <type_traits>
 
 namespace cyaml
 {
     template<typename T>
     Node &Node::operator=(const T &rhs)
     {
-        Node node = Converter<T>::encode(rhs);
-
-        auto refs = data_->refs;
-        for (auto *i : refs) {
-            i->type_ = node.type_;
-            i->style_ = node.style_;
-            i->data_ = node.data_;
-            node.data_->insert_ref(i);
-        }
-        refs.clear();
-
-        return *this;
+        return *this = Converter<T>::encode(rhs);
     }
 
     template<typename T>
@@ -40,8 +30,65 @@ namespace cyaml
     template<typename T>
     bool Node::push_back(const T &rhs)
     {
-        Node node = Converter<T>::encode(rhs);
-        return push_back(node);
+        return emplace_back(rhs);
+    }
+
+    template<typename... Args>
+    bool Node::emplace_back(Args &&... args)
+    {
+        if (is_null()) {
+            reset(Node_Type::SEQ);
+        }
+
+        if (!is_seq())
+            return false;
+
+        check_mutable();
+        append(make_child(std::forward<Args>(args)...));
+
+        return true;
+    }
+
+    template<typename K, typename... Args>
+    bool Node::emplace(K &&key, Args &&... args)
+    {
+        if (is_null()) {
+            reset(Node_Type::MAP);
+        }
+
+        if (!is_map())
+            return false;
+
+        check_mutable();
+        insert(make_child(std::forward<K>(key)),
+               make_child(std::forward<Args>(args)...));
+
+        return true;
+    }
+
+    template<typename... Args>
+    Node_Ptr Node::make_child(Args &&... args) const
+    {
+        auto *resource = this->resource();
+
+        if constexpr (sizeof...(Args) == 0) {
+            return make_pmr_shared<Node>(resource, Node_Type::NONE, resource);
+        } else if constexpr (std::is_constructible_v<
+                                     Node, Args...,
+                                     std::pmr::memory_resource *>) {
+            return make_pmr_shared<Node>(
+                    resource, std::forward<Args>(args)..., resource);
+        } else if constexpr (std::is_constructible_v<Node, Args...>) {
+            return make_pmr_shared<Node>(
+                    resource, std::forward<Args>(args)...);
+        } else {
+            // 其它类型通过 Converter 转换后移动到子节点中
+            static_assert(sizeof...(Args) == 1, "no matching constructor");
+            return make_pmr_shared<Node>(
+                    resource,
+                    Converter<std::decay_t<Args>...>::encode(
+                            std::forward<Args>(args)...));
+        }
     }
 } // namespace cyaml
 
@@ -0,0 +1,72 @@
+/**
+ * @file        patch.h
+ * @brief       节点树差异比较与补丁
+ * @details     主要包含 diff 和 apply_patch 函数声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_PATCH_H
+#define CYAML_PATCH_H
+
+#include "cyaml/type/node/node.h"
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @enum    Patch_Op
+     * @brief   补丁操作类型
+     */
+    enum class Patch_Op
+    {
+        ADD,    // 添加键值对，或在数组下标处插入元素
+        REMOVE, // 删除键值对或数组元素
+        REPLACE // 替换节点
+    };
+
+    /**
+     * @struct  Patch_Entry
+     * @brief   单条修改
+     * @details path 为从根节点到目标节点的路径，每一项为 map 的键，
+     *          父节点为 sequence 时为元素下标的标量；
+     *          path 为空表示根节点
+     */
+    struct Patch_Entry
+    {
+        Patch_Op op;
+        std::vector<Node> path; // 目标节点路径
+        Node value;             // 新值，REMOVE 时为空
+    };
+
+    using Patch = std::vector<Patch_Entry>;
+
+    /**
+     * @brief   比较两棵节点树的差异
+     * @details 冻结的节点树中相同数据或哈希不同的子树直接判断，
+     *          只对有差异的子树递归；比较过程不写入节点的哈希缓存；
+     *          map 按键匹配，键顺序的变化不计入差异；
+     *          sequence 跳过相同的开头和结尾，中间部分按下标比较，
+     *          多出的元素记录为插入或删除
+     * @param   old_node    原节点树
+     * @param   new_node    新节点树
+     * @return  Patch
+     */
+    Patch diff(const Node &old_node, const Node &new_node);
+
+    /**
+     * @brief   将补丁应用到节点树
+     * @details 按顺序执行补丁中的修改，补丁中的值克隆后写入节点树；
+     *          对 diff(a, b) 的结果，应用后 a 与 b 的键值对和元素相同，
+     *          但 diff 不记录键顺序，map 中键的顺序不会恢复，
+     *          新增的键位于末尾，按顺序比较的 operator== 可能仍不相等；
+     *          不命名为 apply，避免未限定的调用通过 ADL 匹配到 std::apply
+     * @param   node    目标节点树
+     * @param   patch   补丁
+     * @return  void
+     * @throw   Dereference_Exception   路径不存在或操作与节点类型不符
+     */
+    void apply_patch(Node &node, const Patch &patch);
+
+} // namespace cyaml
+
+#endif // CYAML_PATCH_H
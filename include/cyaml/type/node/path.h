@@ -0,0 +1,205 @@
+/**
+ * @file        path.h
+ * @brief       节点路径查询
+ * @details     主要包含 Path 类声明，路径表达式编译一次后可以多次求值
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_PATH_H
+#define CYAML_PATH_H
+
+#include "cyaml/type/node/node.h"
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @enum    Path_Segment_Type
+     * @brief   路径项类型
+     */
+    enum class Path_Segment_Type
+    {
+        KEY,      // map 的键或 sequence 的下标
+        ANY,      // *，任意一个子节点
+        RECURSIVE // **，任意层数的子孙节点，包括当前节点
+    };
+
+    /**
+     * @struct  Path_Segment
+     * @brief   路径项
+     */
+    struct Path_Segment
+    {
+        Path_Segment_Type type;
+        std::string key;    // 转义后的键
+        int64_t index = -1; // 键为非负整数时作为下标，否则为 -1
+    };
+
+    /**
+     * @struct  Path_Component
+     * @brief   节点在树中的位置项，用于在事件流中匹配路径
+     * @details 父节点为 sequence 时 index 为元素下标；
+     *          父节点为 map 时 key 为键的标量，键不是标量时 valid 为 false
+     */
+    struct Path_Component
+    {
+        std::string_view key;
+        int64_t index = -1;
+        bool valid = true;
+    };
+
+    /**
+     * @class   Path
+     * @brief   编译后的路径表达式
+     * @details 语法为 JSON Pointer (RFC 6901)，并扩展了通配符：
+     *          ""          根节点；
+     *          "/a/b/0"    逐级查找键 a、键 b、下标 0，~1 表示 /，~0 表示 ~；
+     *          路径项为 * 时匹配任意一个子节点，
+     *          为 ** 时匹配当前节点及任意层数的子孙节点
+     */
+    class Path
+    {
+    private:
+        std::vector<Path_Segment> segments_; // 路径项
+
+    public:
+        /**
+         * @brief   编译路径表达式
+         * @param   expr    路径表达式
+         * @throw   Parse_Exception     表达式格式错误
+         */
+        explicit Path(std::string_view expr);
+
+        /**
+         * @brief   获取路径项
+         * @return  const std::vector<Path_Segment> &
+         */
+        const std::vector<Path_Segment> &segments() const
+        {
+            return segments_;
+        }
+
+        /**
+         * @brief   查找第一个匹配的节点
+         * @details 不创建临时节点，路径不存在时返回空指针而不抛出异常
+         * @param   root    根节点
+         * @return  const Node *
+         * @retval  nullptr:    没有匹配的节点
+         */
+        const Node *find(const Node &root) const;
+
+        /**
+         * @brief   查找所有匹配的节点
+         * @details 按文档顺序返回，返回的指针在节点树被修改前有效；
+         *          匹配节点的子孙节点同样匹配时一并返回，
+         *          而在事件流中查找的 cyaml::select 只返回最外层的节点
+         * @param   root    根节点
+         * @return  std::vector<const Node *>
+         */
+        std::vector<const Node *> select(const Node &root) const;
+
+        /**
+         * @brief   判断位置是否与路径完全匹配
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        bool match(const std::vector<Path_Component> &location) const
+        {
+            return match(0, location, 0);
+        }
+
+        /**
+         * @brief   判断位置的子孙节点是否可能与路径匹配
+         * @details 返回 false 时可以跳过该位置的整个子树
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        bool prefix(const std::vector<Path_Component> &location) const
+        {
+            return prefix(0, location, 0);
+        }
+
+    private:
+        /**
+         * @brief   从指定路径项开始查找
+         * @param   node        当前节点
+         * @param   pos         路径项位置
+         * @param   result      匹配结果
+         * @param   first_only  是否只查找第一个
+         * @return  bool
+         * @retval  true:   已找到第一个，停止查找
+         */
+        bool select(
+                const Node &node,
+                size_t pos,
+                std::vector<const Node *> &result,
+                bool first_only) const;
+
+        bool match(
+                size_t pos,
+                const std::vector<Path_Component> &location,
+                size_t depth) const;
+
+        bool prefix(
+                size_t pos,
+                const std::vector<Path_Component> &location,
+                size_t depth) const;
+    };
+
+    /**
+     * @class   Selector
+     * @brief   节点选择条件
+     * @details 由多个路径或一个位置判断函数构成，满足任意一个路径即为选中；
+     *          使用判断函数时无法提前判断子树能否匹配，不会跳过子树
+     */
+    class Selector
+    {
+    public:
+        using Location = std::vector<Path_Component>;
+        using Predicate = std::function<bool(const Location &location)>;
+
+    private:
+        std::vector<Path> paths_; // 路径
+        Predicate predicate_;     // 位置判断函数
+
+    public:
+        Selector(Path path);
+        Selector(std::vector<Path> paths);
+        Selector(std::initializer_list<Path> paths);
+
+        /**
+         * @brief   使用位置判断函数构造
+         * @tparam  F           可调用类型，参数为 const Location &，返回 bool
+         * @param   predicate   位置判断函数
+         */
+        template<
+                typename F,
+                typename = std::enable_if_t<
+                        std::is_invocable_r_v<bool, F &, const Location &>>>
+        Selector(F predicate): predicate_(std::move(predicate))
+        {
+        }
+
+        /**
+         * @brief   判断位置是否选中
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        bool match(const Location &location) const;
+
+        /**
+         * @brief   判断位置的子孙节点是否可能选中
+         * @param   location    从根节点开始的位置
+         * @return  bool
+         */
+        bool prefix(const Location &location) const;
+    };
+
+} // namespace cyaml
+
+#endif // CYAML_PATH_H
@@ -0,0 +1,76 @@
+/**
+ * @file        usage.h
+ * @brief       节点树内存统计
+ * @details     主要包含 memory_usage 函数声明
+ * @date        2026-10-18
+ */
+
+#ifndef CYAML_USAGE_H
+#define CYAML_USAGE_H
+
+#include "cyaml/type/node/node.h"
+#include <string>
+#include <vector>
+
+namespace cyaml
+{
+    /**
+     * @struct  Container_Usage
+     * @brief   单个集合的统计
+     */
+    struct Container_Usage
+    {
+        std::string path; // 集合路径，格式与 Path 相同，集合键记为 ?
+        Node_Type type;   // 集合类型
+        size_t size;      // 直接子节点数
+    };
+
+    /**
+     * @struct  Memory_Usage
+     * @brief   节点树内存统计结果
+     * @details 字节数按对象大小和容器容量估算，不包括内存资源自身的开销；
+     *          别名和写时复制共享的数据只统计一次
+     */
+    struct Memory_Usage
+    {
+        size_t node_bytes = 0;      // Node 对象及共享指针控制块
+        size_t data_bytes = 0;      // Node_Data 对象及共享指针控制块
+        size_t container_bytes = 0; // map 和 sequence 的数组
+        size_t scalar_bytes = 0;    // 标量字符串的堆内存
+        size_t ref_bytes = 0;       // 引用集合的哈希表
+        size_t source_bytes = 0;    // 延迟加载节点的附加状态和源数据
+
+        size_t map_count = 0;    // map 节点数
+        size_t seq_count = 0;    // sequence 节点数
+        size_t scalar_count = 0; // 标量节点数
+        size_t null_count = 0;   // 空值节点数
+        size_t lazy_count = 0;   // 尚未构建子节点的延迟加载节点数
+        size_t shared_count = 0; // 数据已被其他节点统计的节点数
+
+        size_t max_depth = 0; // 最大层数，根节点为第 1 层
+
+        std::vector<Container_Usage> largest; // 子节点最多的集合，按大小降序
+
+        /**
+         * @brief   总字节数
+         * @return  size_t
+         */
+        size_t total() const
+        {
+            return node_bytes + data_bytes + container_bytes + scalar_bytes +
+                   ref_bytes + source_bytes;
+        }
+    };
+
+    /**
+     * @brief   统计节点树的内存占用
+     * @details 一次遍历完成统计，不会构建延迟加载的子节点
+     * @param   node        根节点
+     * @param   largest     记录的最大集合个数
+     * @return  Memory_Usage
+     */
+    Memory_Usage memory_usage(const Node &node, size_t largest = 8);
+
+} // namespace cyaml
+
+#endif // CYAML_USAGE_H
@@ -71,10 +71,16 @@ namespace cyaml
     {
     }
 
+    Frozen_Exception::Frozen_Exception()
+        : Representation_Exception(error_msgs::MODIFY_FROZEN, Mark())
+    {
+    }
+
     Exception::~Exception() = default;
     Parse_Exception::~Parse_Exception() = default;
     Representation_Exception::~Representation_Exception() = default;
     Dereference_Exception::~Dereference_Exception() = default;
     Convertion_Exception::~Convertion_Exception() = default;
+    Frozen_Exception::~Frozen_Exception() = default;
 
 } // namespace cyaml
@@ -6,39 +6,44 @@
  */
 
 #include "cyaml/parser/api.h"
+#include "cyaml/parser/lazy_builder.h"
 #include "cyaml/parser/node_builder.h"
 #include "cyaml/parser/parser.h"
+#include "cyaml/parser/path_handler.h"
 #include "cyaml/parser/serializer.h"
+#include "cyaml/parser/snapshot.h"
 #include "cyaml/error/exceptions.h"
 #include <fstream>
 #include <sstream>
 
 namespace cyaml
 {
-    Node load(std::istream &input)
+    Node load(std::istream &input, std::pmr::memory_resource *resource)
     {
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser(input, builder).parse_next_document();
         return builder.root();
     }
 
-    Node load(const std::string &input)
+    Node load(const std::string &input, std::pmr::memory_resource *resource)
     {
         std::stringstream ss(input);
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser(ss, builder).parse_next_document();
         return builder.root();
     }
 
-    Node load(const char *input)
+    Node load(const char *input, std::pmr::memory_resource *resource)
     {
         std::stringstream ss(input);
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser(ss, builder).parse_next_document();
         return builder.root();
     }
 
-    Node load_file(const std::string &file)
+    Node load_file(
+            const std::string &file,
+            std::pmr::memory_resource *resource)
     {
         std::ifstream ifs(file);
 
@@ -46,7 +51,7 @@ namespace cyaml
             throw Exception("Failed to open \"" + file + "\"", Mark());
         }
 
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser(ifs, builder).parse_next_document();
         Node ret = builder.root();
         ifs.close();
@@ -54,10 +59,202 @@ namespace cyaml
         return ret;
     }
 
-    std::vector<Node> load_all(std::istream &input)
+    /**
+     * @brief   从输入流加载，共享节点数据
+     * @param   input       输入流
+     * @param   mode        共享方式
+     * @param   key_table   键表，可以为空
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    static Node load_shared(
+            std::istream &input,
+            Intern_Mode mode,
+            Key_Table *key_table,
+            std::pmr::memory_resource *resource)
+    {
+        Node_Builder builder(resource, mode, key_table);
+        Parser(input, builder).parse_next_document();
+        return builder.root();
+    }
+
+    /**
+     * @brief   从文件加载，共享节点数据
+     * @param   file        文件路径
+     * @param   mode        共享方式
+     * @param   key_table   键表，可以为空
+     * @param   resource    节点内存资源
+     * @return  Node
+     */
+    static Node load_file_shared(
+            const std::string &file,
+            Intern_Mode mode,
+            Key_Table *key_table,
+            std::pmr::memory_resource *resource)
+    {
+        std::ifstream ifs(file);
+
+        if (!ifs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        return load_shared(ifs, mode, key_table, resource);
+    }
+
+    Node load(
+            std::istream &input,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        return load_shared(input, mode, nullptr, resource);
+    }
+
+    Node load(
+            const std::string &input,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        std::stringstream ss(input);
+        return load_shared(ss, mode, nullptr, resource);
+    }
+
+    Node load_file(
+            const std::string &file,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        return load_file_shared(file, mode, nullptr, resource);
+    }
+
+    Node load(
+            std::istream &input,
+            Key_Table &key_table,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        return load_shared(input, mode, &key_table, resource);
+    }
+
+    Node load(
+            const std::string &input,
+            Key_Table &key_table,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        std::stringstream ss(input);
+        return load_shared(ss, mode, &key_table, resource);
+    }
+
+    Node load_file(
+            const std::string &file,
+            Key_Table &key_table,
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+    {
+        return load_file_shared(file, mode, &key_table, resource);
+    }
+
+    /**
+     * @brief   将选中的节点放到结果节点树中的对应位置
+     * @param   root        结果节点树
+     * @param   location    选中节点的位置
+     * @param   node        选中的节点
+     * @return  void
+     */
+    static void place(
+            Node &root,
+            const Path_Handler::Location &location,
+            const Node &node)
+    {
+        for (auto &component : location) {
+            if (!component.valid)
+                return;
+        }
+
+        Node *current = &root;
+        for (auto &component : location) {
+            if (component.index >= 0) {
+                auto index = static_cast<uint32_t>(component.index);
+                while (current->size() <= index) {
+                    current->push_back(Node());
+                }
+                current = &(*current)[index];
+            } else {
+                current = &(*current)[std::string(component.key)];
+            }
+        }
+
+        *current = node;
+    }
+
+    Node load(
+            std::istream &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        Node root(Node_Type::NONE, resource);
+        Path_Handler handler(
+                selector,
+                [&](const Path_Handler::Location &location, const Node &node) {
+                    place(root, location, node);
+                },
+                resource);
+        Parser(input, handler).parse_next_document();
+
+        return root;
+    }
+
+    Node load(
+            const std::string &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        std::stringstream ss(input);
+        return load(ss, selector, resource);
+    }
+
+    Node load_file(
+            const std::string &file,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        std::ifstream ifs(file);
+
+        if (!ifs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        return load(ifs, selector, resource);
+    }
+
+    Node load_lazy(std::string input, std::pmr::memory_resource *resource)
+    {
+        return Lazy_Builder::load(
+                std::make_shared<const std::string>(std::move(input)),
+                resource);
+    }
+
+    Node load_file_lazy(
+            const std::string &file,
+            std::pmr::memory_resource *resource)
+    {
+        std::ifstream ifs(file, std::ios::binary);
+
+        if (!ifs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        return load_lazy(ss.str(), resource);
+    }
+
+    std::vector<Node> load_all(
+            std::istream &input,
+            std::pmr::memory_resource *resource)
     {
         std::vector<Node> nodes;
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser parser(input, builder);
         while (parser.parse_next_document()) {
             nodes.push_back(builder.root());
@@ -66,10 +263,12 @@ namespace cyaml
         return nodes;
     }
 
-    std::vector<Node> load_all(const std::string &input)
+    std::vector<Node> load_all(
+            const std::string &input,
+            std::pmr::memory_resource *resource)
     {
         std::vector<Node> nodes;
-        Node_Builder builder;
+        Node_Builder builder(resource);
         std::stringstream ss(input);
         Parser parser(ss, builder);
         while (parser.parse_next_document()) {
@@ -79,10 +278,12 @@ namespace cyaml
         return nodes;
     }
 
-    std::vector<Node> load_all(const char *input)
+    std::vector<Node> load_all(
+            const char *input,
+            std::pmr::memory_resource *resource)
     {
         std::vector<Node> nodes;
-        Node_Builder builder;
+        Node_Builder builder(resource);
         std::stringstream ss(input);
         Parser parser(ss, builder);
         while (parser.parse_next_document()) {
@@ -92,7 +293,9 @@ namespace cyaml
         return nodes;
     }
 
-    std::vector<Node> load_file_all(const std::string &file)
+    std::vector<Node> load_file_all(
+            const std::string &file,
+            std::pmr::memory_resource *resource)
     {
         std::ifstream ifs(file);
 
@@ -101,7 +304,7 @@ namespace cyaml
         }
 
         std::vector<Node> nodes;
-        Node_Builder builder;
+        Node_Builder builder(resource);
         Parser parser(ifs, builder);
         while (parser.parse_next_document()) {
             nodes.push_back(builder.root());
@@ -111,7 +314,47 @@ namespace cyaml
         return nodes;
     }
 
-    void dump(const std::string &file, const Node &node)
+    std::vector<Node> select(
+            std::istream &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        std::vector<Node> nodes;
+        Path_Handler handler(
+                selector,
+                [&](const Path_Handler::Location &, const Node &node) {
+                    nodes.push_back(node);
+                },
+                resource);
+        Parser(input, handler).parse_next_document();
+
+        return nodes;
+    }
+
+    std::vector<Node> select(
+            const std::string &input,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        std::stringstream ss(input);
+        return select(ss, selector, resource);
+    }
+
+    std::vector<Node> select_file(
+            const std::string &file,
+            const Selector &selector,
+            std::pmr::memory_resource *resource)
+    {
+        std::ifstream ifs(file);
+
+        if (!ifs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        return select(ifs, selector, resource);
+    }
+
+    void dump(const std::string &file, const Node &node, Dump_Format format)
     {
         std::ofstream ofs(file);
 
@@ -119,15 +362,122 @@ namespace cyaml
             throw Exception("Failed to open \"" + file + "\"", Mark());
         }
 
-        ofs << node;
+        Serializer(ofs, format).serialize(node);
         ofs.close();
     }
 
-    std::string dump(const Node &node)
+    std::string dump(const Node &node, Dump_Format format)
+    {
+        std::string str;
+        Serializer(str, format).serialize(node);
+        return str;
+    }
+
+    std::string dump_parallel(
+            const Node &node,
+            Dump_Format format,
+            size_t threads)
+    {
+        std::string str;
+        Serializer(str, format).serialize_parallel(node, threads);
+        return str;
+    }
+
+    size_t dump_size(const Node &node, Dump_Format format)
+    {
+        Serializer serializer(nullptr, 0, format);
+        serializer.serialize(node);
+        return serializer.size();
+    }
+
+    void dump_to(std::string &out, const Node &node, Dump_Format format)
+    {
+        // 第一遍直接写入已有的容量，同时得到准确长度
+        out.resize(out.capacity());
+        size_t size = dump_to(out.data(), out.size(), node, format);
+
+        // 容量不足时按准确长度调整一次大小，再写入一遍
+        bool fit = size <= out.size();
+        out.resize(size);
+        if (!fit)
+            Serializer(out.data(), out.size(), format).serialize(node);
+    }
+
+    size_t dump_to(
+            char *buffer,
+            size_t capacity,
+            const Node &node,
+            Dump_Format format)
+    {
+        Serializer serializer(buffer, capacity, format);
+        serializer.serialize(node);
+        return serializer.size();
+    }
+
+    std::string dump_preserved(const Node &node)
     {
-        std::ostringstream oss;
-        oss << node;
-        return oss.str();
+        std::string str;
+        Serializer(str).serialize_preserved(node);
+        return str;
+    }
+
+    void dump_preserved(const std::string &file, const Node &node)
+    {
+        std::ofstream ofs(file, std::ios::binary);
+
+        if (!ofs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        Serializer(ofs).serialize_preserved(node);
+        ofs.close();
+    }
+
+    std::string save_snapshot(const Node &node)
+    {
+        std::string str;
+        Snapshot_Writer(str).write(node);
+        return str;
+    }
+
+    void save_snapshot(const std::string &file, const Node &node)
+    {
+        std::ofstream ofs(file, std::ios::binary);
+
+        if (!ofs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        std::string str = save_snapshot(node);
+        ofs.write(str.data(), str.size());
+        ofs.close();
+    }
+
+    Node load_snapshot(
+            std::string_view data,
+            std::pmr::memory_resource *resource)
+    {
+        return Snapshot_Reader(data, resource).root();
+    }
+
+    Node load_snapshot_file(
+            const std::string &file,
+            std::pmr::memory_resource *resource)
+    {
+        std::ifstream ifs(file, std::ios::binary);
+
+        if (!ifs.is_open()) {
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        // 按文件大小一次读入
+        ifs.seekg(0, std::ios::end);
+        std::string data(static_cast<size_t>(ifs.tellg()), '\0');
+        ifs.seekg(0, std::ios::beg);
+        ifs.read(data.data(), data.size());
+        ifs.close();
+
+        return load_snapshot(data, resource);
     }
 
     std::ostream &operator<<(std::ostream &out, const Node &node)
@@ -0,0 +1,230 @@
+/**
+ * @file        emitter.cpp
+ * @brief       事件驱动的流式输出
+ * @details     主要包含 Emitter 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/emitter.h"
+#include "cyaml/error/error_msgs.h"
+#include "cyaml/error/exceptions.h"
+#include "cyaml/parser/scalar_style.h"
+#include <algorithm>
+
+namespace cyaml
+{
+    Emitter::Emitter(std::ostream &out): output_(out) {}
+
+    Emitter::Emitter(int fd): output_(fd) {}
+
+    Emitter::Emitter(std::string &out): output_(out) {}
+
+    void Emitter::begin_document()
+    {
+        if (!frames_.empty())
+            fail(error_msgs::UNCLOSED_COLLECTION);
+
+        if (root_done_) {
+            if (column() > 1)
+                output_.write_new_line();
+            output_.write("---\n");
+        }
+        root_done_ = false;
+    }
+
+    void Emitter::end_document()
+    {
+        if (!frames_.empty())
+            fail(error_msgs::UNCLOSED_COLLECTION);
+
+        output_.flush();
+    }
+
+    void Emitter::begin_map(Node_Style style, std::string_view anchor)
+    {
+        begin_collection(true, style, anchor);
+    }
+
+    void Emitter::end_map()
+    {
+        end_collection(true);
+    }
+
+    void Emitter::begin_seq(Node_Style style, std::string_view anchor)
+    {
+        begin_collection(false, style, anchor);
+    }
+
+    void Emitter::end_seq()
+    {
+        end_collection(false);
+    }
+
+    void Emitter::scalar(std::string_view value, std::string_view anchor)
+    {
+        auto context = Scalar_Context::BLOCK;
+        uint32_t indent = 0;
+        if (!frames_.empty()) {
+            const Frame &frame = frames_.back();
+            if (frame.flow) {
+                context = Scalar_Context::FLOW;
+            } else if (frame.map && frame.key_turn) {
+                context = Scalar_Context::KEY;
+            }
+            indent = increase(frame.indent);
+        }
+
+        begin_node(false, anchor);
+        write_scalar(output_, value, context, std::max(indent, indent_inc_));
+        end_node(false);
+    }
+
+    void Emitter::null(std::string_view anchor)
+    {
+        begin_node(false, anchor);
+        output_.write("null");
+        end_node(false);
+    }
+
+    void Emitter::alias(std::string_view name)
+    {
+        bool key = !frames_.empty() && frames_.back().map &&
+                   frames_.back().key_turn;
+
+        begin_node(false, {});
+        output_.write('*');
+        output_.write(name);
+
+        // 冒号可以是别名的一部分，作为键时需要隔开
+        if (key)
+            output_.write(' ');
+        end_node(false);
+    }
+
+    void Emitter::fill_blank(uint32_t indent)
+    {
+        if (column() < indent + 1) {
+            output_.write_space(indent + 1 - column());
+        }
+    }
+
+    void Emitter::begin_node(bool block, std::string_view anchor)
+    {
+        // 块集合的锚点单独占一行，集合内容从下一行开始
+        auto write_anchor = [&]() {
+            output_.write('&');
+            output_.write(anchor);
+            if (block) {
+                output_.write_new_line();
+            } else {
+                output_.write(' ');
+            }
+        };
+
+        if (frames_.empty()) {
+            if (root_done_)
+                fail(error_msgs::MULTIPLE_ROOTS);
+            if (!anchor.empty())
+                write_anchor();
+            return;
+        }
+
+        Frame &frame = frames_.back();
+        if (frame.flow) {
+            if (frame.map && !frame.key_turn) {
+                output_.write(": ");
+            } else if (frame.first) {
+                frame.first = false;
+            } else {
+                output_.write(", ");
+            }
+            if (!anchor.empty())
+                write_anchor();
+            return;
+        }
+
+        fill_blank(frame.indent);
+        if (!frame.map) {
+            output_.write("- ");
+            if (!anchor.empty()) {
+                write_anchor();
+            } else if (block) {
+                output_.write_new_line();
+            }
+        } else if (frame.key_turn) {
+            if (block)
+                output_.write("? ");
+            if (!anchor.empty())
+                write_anchor();
+        } else {
+            output_.write(": ");
+            if (!anchor.empty()) {
+                write_anchor();
+            } else if (column() > increase(frame.indent) + 1 && block) {
+                output_.write_new_line();
+            }
+        }
+    }
+
+    void Emitter::end_node(bool block)
+    {
+        if (frames_.empty()) {
+            root_done_ = true;
+            return;
+        }
+
+        Frame &frame = frames_.back();
+        if (frame.flow) {
+            if (frame.map)
+                frame.key_turn = !frame.key_turn;
+            return;
+        }
+
+        if (!frame.map) {
+            if (!block)
+                output_.write_new_line();
+        } else if (frame.key_turn) {
+            frame.key_turn = false;
+        } else {
+            if (!block)
+                output_.write_new_line();
+            frame.key_turn = true;
+        }
+    }
+
+    void Emitter::begin_collection(
+            bool map,
+            Node_Style style,
+            std::string_view anchor)
+    {
+        // 流式集合中的节点总是以流式输出
+        bool flow = style == Node_Style::FLOW || in_flow();
+        begin_node(!flow, anchor);
+        if (flow)
+            output_.write(map ? '{' : '[');
+
+        uint32_t indent =
+                frames_.empty() ? 0 : increase(frames_.back().indent);
+        frames_.push_back({map, flow, indent});
+    }
+
+    void Emitter::end_collection(bool map)
+    {
+        if (frames_.empty() || frames_.back().map != map)
+            fail(error_msgs::UNMATCHED_END);
+        if (map && !frames_.back().key_turn)
+            fail(error_msgs::MISSING_VALUE);
+
+        bool flow = frames_.back().flow;
+        frames_.pop_back();
+        if (flow)
+            output_.write(map ? '}' : ']');
+        end_node(!flow);
+    }
+
+    void Emitter::fail(const char *msg) const
+    {
+        throw Exception(msg, Mark(line(), column()));
+    }
+
+} // namespace cyaml
@@ -0,0 +1,151 @@
+/**
+ * @file        intern_table.cpp
+ * @brief       加载时共享相同的节点数据
+ * @details     主要包含 Intern_Table 和 Key_Table 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/intern_table.h"
+
+namespace cyaml
+{
+    Intern_Table::Intern_Table(
+            Intern_Mode mode,
+            std::pmr::memory_resource *resource)
+        : mode_(mode), resource_(resource)
+    {
+    }
+
+    Node_Ptr Intern_Table::scalar(const std::string &value)
+    {
+        auto iter = scalars_.find(value);
+        if (iter == scalars_.end()) {
+            auto node = make_pmr_shared<Node>(resource_, value, resource_);
+            node->freeze();
+
+            // 冻结数据不会再修改，键可以直接引用其中的字符串
+            std::string_view key = node->data_->scalar;
+            iter = scalars_.emplace(key, std::move(node)).first;
+        }
+
+        return make_pmr_shared<Node>(resource_, *iter->second);
+    }
+
+    Node_Ptr Intern_Table::null()
+    {
+        if (!null_) {
+            null_ = make_pmr_shared<Node>(
+                    resource_, Node_Type::NONE, resource_);
+            null_->freeze();
+        }
+
+        return make_pmr_shared<Node>(resource_, *null_);
+    }
+
+    void Intern_Table::subtree(const Node_Ptr &node, size_t hash)
+    {
+        if (mode_ != Intern_Mode::SUBTREE)
+            return;
+
+        if (!node->is_map() && !node->is_seq())
+            return;
+
+        // 子节点的哈希都已记录在构建器中，这里直接写入缓存
+        auto &body = *node->data_;
+        body.hash = hash;
+        body.hash_state = Hash_State::VALID;
+
+        auto range = subtrees_.equal_range(hash);
+        for (auto iter = range.first; iter != range.second; iter++) {
+            auto &shared = iter->second;
+            if (shared->type_ != node->type_ || *shared != *node)
+                continue;
+
+            // 第一次重复，已记录的子树转移到冻结数据中，原节点改为引用
+            if (!shared->data_->frozen) {
+                auto frozen = make_pmr_shared<Node>(
+                        resource_, shared->type_, resource_);
+                auto &data = *frozen->data_;
+                data.map.swap(shared->data_->map);
+                data.seq.swap(shared->data_->seq);
+                for (auto &[key, value] : data.map) {
+                    key->parent_ = value->parent_ = &data;
+                }
+                for (auto &i : data.seq) {
+                    i->parent_ = &data;
+                }
+                data.hash = hash;
+                data.hash_state = Hash_State::VALID;
+                frozen->freeze();
+                shared->data_->source = frozen->data_;
+                shared = std::move(frozen);
+            }
+
+            auto &data = *node->data_;
+            data.map.clear();
+            data.map.shrink_to_fit();
+            data.seq.clear();
+            data.seq.shrink_to_fit();
+            data.source = shared->data_;
+            return;
+        }
+
+        subtrees_.emplace(hash, node);
+    }
+
+    Key_Table::Key_Table(std::pmr::memory_resource *resource)
+        : resource_(resource)
+    {
+    }
+
+    Key_Table &Key_Table::global()
+    {
+        static Key_Table table;
+        return table;
+    }
+
+    Node Key_Table::key(const std::string &key)
+    {
+        return find(key);
+    }
+
+    Node_Ptr Key_Table::make_key(
+            const std::string &key,
+            std::pmr::memory_resource *resource)
+    {
+        return make_pmr_shared<Node>(resource, find(key));
+    }
+
+    size_t Key_Table::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return keys_.size();
+    }
+
+    const Node &Key_Table::find(const std::string &key)
+    {
+        // 加载时绝大多数键已在表中，只需要读锁
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto iter = keys_.find(key);
+            if (iter != keys_.end())
+                return *iter->second;
+        }
+
+        // 释放读锁后其它线程可能已加入同一个键，加写锁后需要再次查找
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto iter = keys_.find(key);
+        if (iter == keys_.end()) {
+            // 冻结时计算哈希，之后只读，可以被多个线程共享
+            auto node = make_pmr_shared<Node>(resource_, key, resource_);
+            node->freeze();
+
+            std::string_view view = node->data_->scalar;
+            iter = keys_.emplace(view, std::move(node)).first;
+        }
+
+        // 表中的节点只增加不删除，返回的引用始终有效
+        return *iter->second;
+    }
+
+} // namespace cyaml
@@ -0,0 +1,502 @@
+/**
+ * @file        lazy_builder.cpp
+ * @brief       延迟构建节点树
+ * @details     包含 Lazy_Builder 事件定义
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/lazy_builder.h"
+#include "cyaml/parser/parser.h"
+#include "cyaml/parser/unicode.h"
+#include "cyaml/error/exceptions.h"
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+
+namespace cyaml
+{
+    /**
+     * @class   Memory_Buffer
+     * @brief   直接读取内存数据的流缓冲区，不复制数据
+     */
+    class Memory_Buffer: public std::streambuf
+    {
+    public:
+        Memory_Buffer(const char *data, size_t size)
+        {
+            char *begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+
+    /**
+     * @class   Padded_Buffer
+     * @brief   先读出若干空格，再直接读取内存数据的流缓冲区
+     * @details 重新解析集合时补齐第一行的缩进，不复制源数据
+     */
+    class Padded_Buffer: public std::streambuf
+    {
+    private:
+        static constexpr uint32_t CHUNK = 64; // 每次提供的空格数
+
+        char spaces_[CHUNK]; // 补齐缩进的空格
+        char *data_;         // 源数据中的范围
+        size_t size_;        // 范围长度
+        uint32_t pad_;       // 剩余的空格数
+        bool padded_;        // 是否需要补齐缩进
+        bool done_ = false;  // 是否已开始读取源数据
+
+    public:
+        Padded_Buffer(const char *data, size_t size, uint32_t pad)
+            : data_(const_cast<char *>(data)),
+              size_(size),
+              pad_(pad),
+              padded_(pad > 0)
+        {
+            std::memset(spaces_, ' ', sizeof(spaces_));
+            setg(data_, data_, data_);
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            if (pad_ > 0) {
+                uint32_t count = std::min(pad_, CHUNK);
+                setg(spaces_, spaces_, spaces_ + count);
+                pad_ -= count;
+            } else if (!done_) {
+                setg(data_, data_, data_ + size_);
+                done_ = true;
+            }
+
+            if (gptr() == egptr())
+                return traits_type::eof();
+            return traits_type::to_int_type(*gptr());
+        }
+
+        int_type pbackfail(int_type ch) override
+        {
+            // 退回到源数据之前补齐的最后一个空格
+            if (padded_ && done_ && gptr() == data_ && ch == ' ') {
+                setg(spaces_, spaces_, spaces_ + 1);
+                done_ = false;
+                return ch;
+            }
+
+            return traits_type::eof();
+        }
+    };
+
+    Lazy_Builder::Lazy_Builder(
+            std::shared_ptr<const std::string> buffer,
+            uint32_t begin,
+            uint32_t end,
+            uint32_t pad,
+            const Node *target,
+            std::pmr::memory_resource *resource)
+        : buffer_(std::move(buffer)),
+          begin_(begin),
+          end_(end),
+          pad_(pad),
+          resource_(resource),
+          data_(target ? target->data_.get() : nullptr),
+          type_(target ? target->type() : Node_Type::NONE),
+          capture_(resource)
+    {
+    }
+
+    Node Lazy_Builder::load(
+            std::shared_ptr<const std::string> buffer,
+            std::pmr::memory_resource *resource)
+    {
+        auto &input = *buffer;
+        bool lazy = input.size() < UINT32_MAX;
+
+        // 只有 utf-8 编码时解析位置才与源数据的字节偏移一致
+        if (lazy) {
+            Memory_Buffer probe_buf(input.data(), input.size());
+            std::istream probe(&probe_buf);
+            lazy = Unicode::check_type(probe) == utf::UTF_8;
+        }
+
+        if (lazy) {
+            uint32_t begin = input.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+            Memory_Buffer lazy_buf(input.data(), input.size());
+            std::istream lazy_in(&lazy_buf);
+            Lazy_Builder builder(
+                    buffer, begin, static_cast<uint32_t>(input.size()), 0,
+                    nullptr, resource);
+            Parser(lazy_in, builder).parse_next_document();
+
+            if (!builder.eager_ && builder.root_) {
+                // 根节点同样记录各条目在源数据中的位置
+                auto &root = *builder.root_;
+                auto range = make_pmr_shared<Lazy_Range>(
+                        resource,
+                        Lazy_Range{
+                                buffer, builder.root_begin_,
+                                static_cast<uint32_t>(input.size()),
+                                builder.indent_ + 1, {}, true});
+                if (scan_entries(*range, root.is_map(), root.size()))
+                    root.data_->track().span = std::move(range);
+                return root;
+            }
+        }
+
+        Memory_Buffer eager_buf(input.data(), input.size());
+        std::istream eager_in(&eager_buf);
+        Node_Builder builder(resource);
+        Parser(eager_in, builder).parse_next_document();
+        return builder.root();
+    }
+
+    void Lazy_Builder::materialize(const Node &node)
+    {
+        auto &state = *node.data_->tracked;
+        auto lazy = std::move(state.lazy);
+        state.lazy = nullptr;
+
+        // 补齐第一行的缩进，使子节点保持原有的层级结构，直接读取源数据
+        Padded_Buffer streambuf(
+                lazy->buffer->data() + lazy->begin, lazy->end - lazy->begin,
+                lazy->column - 1);
+        std::istream in(&streambuf);
+        Lazy_Builder builder(
+                lazy->buffer, lazy->begin, lazy->end, lazy->column - 1, &node,
+                node.resource());
+
+        try {
+            Parser(in, builder).parse_next_document();
+        } catch (...) {
+            // 构建失败时恢复为未构建状态
+            node.data_->map.clear();
+            node.data_->seq.clear();
+            state.lazy = std::move(lazy);
+            throw;
+        }
+
+        auto &data = *node.data_;
+        size_t count = node.is_map() ? data.map.size() : data.seq.size();
+        if (scan_entries(*lazy, node.is_map(), count))
+            state.span = std::move(lazy);
+    }
+
+    void Lazy_Builder::on_map_start(
+            const Mark &mark,
+            std::string anchor,
+            Node_Style style)
+    {
+        begin_collection(Node_Type::MAP, mark, anchor, style);
+        if (captured_)
+            capture_.on_map_start(mark, std::move(anchor), style);
+    }
+
+    void Lazy_Builder::on_map_end()
+    {
+        if (captured_)
+            capture_.on_map_end();
+        end_collection();
+    }
+
+    void Lazy_Builder::on_seq_start(
+            const Mark &mark,
+            std::string anchor,
+            Node_Style style)
+    {
+        begin_collection(Node_Type::SEQ, mark, anchor, style);
+        if (captured_)
+            capture_.on_seq_start(mark, std::move(anchor), style);
+    }
+
+    void Lazy_Builder::on_seq_end()
+    {
+        if (captured_)
+            capture_.on_seq_end();
+        end_collection();
+    }
+
+    void Lazy_Builder::on_scalar(
+            const Mark &mark,
+            std::string anchor,
+            std::string value)
+    {
+        if (captured_) {
+            capture_.on_scalar(mark, std::move(anchor), std::move(value));
+        } else if (scalar_node(anchor)) {
+            add_child(
+                    make_pmr_shared<Node>(resource_, value, resource_), mark);
+        }
+    }
+
+    void Lazy_Builder::on_null(const Mark &mark, std::string anchor)
+    {
+        if (captured_) {
+            capture_.on_null(mark, std::move(anchor));
+        } else if (scalar_node(anchor)) {
+            add_child(
+                    make_pmr_shared<Node>(
+                            resource_, Node_Type::NONE, resource_),
+                    mark);
+        }
+    }
+
+    void Lazy_Builder::on_alias(const Mark &mark, std::string anchor)
+    {
+        // 别名引用的节点可能尚未构建
+        eager_ = true;
+    }
+
+    Mark Lazy_Builder::source_mark(const Mark &mark) const
+    {
+        auto &text = *buffer_;
+        auto end = text.begin() + offset(mark);
+        uint32_t line = std::count(text.begin(), end, '\n') + 1;
+        return Mark(line, mark.column);
+    }
+
+    void Lazy_Builder::begin_collection(
+            Node_Type type,
+            const Mark &mark,
+            const std::string &anchor,
+            Node_Style style)
+    {
+        if (!anchor.empty())
+            eager_ = true;
+
+        if (eager_)
+            return;
+
+        if (captured_) {
+            captured_++;
+            return;
+        }
+
+        if (skip_) {
+            skip_++;
+            return;
+        }
+
+        // 根节点只构建直接子节点
+        if (depth_ == 0) {
+            depth_ = 1;
+            indent_ = mark.column - 1;
+            root_begin_ = offset(mark);
+            if (data_)
+                return;
+
+            if (style != Node_Style::BLOCK) {
+                eager_ = true;
+                return;
+            }
+
+            root_ = make_pmr_shared<Node>(resource_, type, resource_);
+            data_ = root_->data_.get();
+            type_ = type;
+            return;
+        }
+
+        // 集合键和 flow 集合直接构建，block 集合值延迟构建
+        if (style != Node_Style::BLOCK ||
+            (type_ == Node_Type::MAP && key_turn_)) {
+            captured_ = 1;
+            capture_mark_ = mark;
+            capture_.on_document_start(mark);
+            return;
+        }
+
+        uint32_t begin = offset(mark);
+        bool indentless = type == Node_Type::SEQ && type_ == Node_Type::MAP &&
+                          mark.column - 1 == indent_;
+
+        auto node = make_pmr_shared<Node>(resource_, type, resource_);
+        node->data_->track().lazy = make_pmr_shared<Lazy_Range>(
+                resource_,
+                Lazy_Range{
+                        buffer_, begin, block_end(begin, indentless),
+                        mark.column, {}, false});
+        add_child(node, mark);
+        skip_ = 1;
+    }
+
+    void Lazy_Builder::end_collection()
+    {
+        if (eager_)
+            return;
+
+        if (captured_) {
+            if (--captured_ == 0) {
+                capture_.on_document_end();
+                add_child(
+                        make_pmr_shared<Node>(resource_, capture_.root()),
+                        capture_mark_);
+            }
+            return;
+        }
+
+        if (skip_) {
+            skip_--;
+            return;
+        }
+
+        depth_ = 0;
+    }
+
+    bool Lazy_Builder::scalar_node(const std::string &anchor)
+    {
+        if (!anchor.empty())
+            eager_ = true;
+
+        if (eager_ || skip_)
+            return false;
+
+        // 根节点为标量时完整加载
+        if (depth_ == 0) {
+            eager_ = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t Lazy_Builder::block_end(uint32_t begin, bool indentless) const
+    {
+        auto &text = *buffer_;
+        uint32_t pos = begin;
+        while (pos < end_) {
+            // 跳到下一行行首
+            while (pos < end_ && text[pos] != '\n')
+                pos++;
+            if (pos == end_)
+                break;
+
+            uint32_t line = ++pos;
+            while (pos < end_ && text[pos] == ' ')
+                pos++;
+
+            char ch = pos < end_ ? text[pos] : '\n';
+            if (ch == '\n' || ch == '\r' || ch == '#' ||
+                pos - line > indent_) {
+                continue;
+            }
+
+            char next = pos + 1 < end_ ? text[pos + 1] : '\n';
+            bool entry = ch == '-' && (next == ' ' || next == '\t' ||
+                                       next == '\r' || next == '\n');
+            if (!indentless || pos - line < indent_ || !entry)
+                return line;
+        }
+
+        return end_;
+    }
+
+    bool Lazy_Builder::scan_entries(
+            Lazy_Range &range,
+            bool map,
+            size_t count)
+    {
+        auto &text = *range.buffer;
+        uint32_t indent = range.column - 1;
+        uint32_t end = range.end;
+        auto &entries = range.entries;
+        entries.reserve(count + 1);
+        entries.push_back(range.begin);
+
+        uint32_t pos = range.begin;
+        while (pos < end) {
+            // 跳到下一行行首
+            auto next = static_cast<const char *>(
+                    std::memchr(text.data() + pos, '\n', end - pos));
+            if (!next)
+                break;
+
+            uint32_t line = next - text.data() + 1;
+            pos = line;
+            while (pos < end && text[pos] == ' ')
+                pos++;
+
+            char ch = pos < end ? text[pos] : '\n';
+            if (ch == '\n' || ch == '\r' || ch == '#' || pos - line != indent)
+                continue;
+
+            auto blank = [&](uint32_t i) {
+                return i >= end || text[i] == ' ' || text[i] == '\t' ||
+                       text[i] == '\r' || text[i] == '\n';
+            };
+
+            // 文档结束标记或下一个文档之后的内容不属于根节点
+            if (indent == 0 &&
+                (text.compare(pos, 3, "---") == 0 ||
+                 text.compare(pos, 3, "...") == 0) &&
+                blank(pos + 3)) {
+                end = line;
+                break;
+            }
+
+            if (map && (ch == ':' || ch == '-') && blank(pos + 1))
+                continue;
+
+            entries.push_back(pos);
+        }
+        entries.push_back(end);
+
+        if (entries.size() != count + 1) {
+            entries = std::vector<uint32_t>();
+            return false;
+        }
+        return true;
+    }
+
+    void Lazy_Builder::track(const Node &node)
+    {
+        auto &data = *node.data_;
+        auto &state = data.track();
+        state.origin = &node;
+        state.modified = false;
+
+        for (auto &[key, value] : data.map) {
+            track(*key);
+            track(*value);
+        }
+
+        for (auto &i : data.seq) {
+            track(*i);
+        }
+    }
+
+    void Lazy_Builder::add_child(const Node_Ptr &node, const Mark &mark)
+    {
+        // 记录子节点的来源，保留格式输出时用于找到源数据中的条目
+        track(*node);
+        if (type_ == Node_Type::SEQ) {
+            node->data_->tracked->entry = data_->seq.size();
+            node->parent_ = data_;
+            data_->seq.emplace_back(node);
+            return;
+        }
+
+        if (key_turn_) {
+            key_ = node;
+            key_turn_ = false;
+            return;
+        }
+
+        key_->data_->tracked->entry = node->data_->tracked->entry =
+                data_->map.size();
+
+        auto &map = data_->map;
+        auto iter = std::find_if(
+                map.begin(), map.end(), [&](const KV_Pair &p) {
+                    return *p.first == *key_;
+                });
+        if (iter != map.end()) {
+            throw Representation_Exception(
+                    error_msgs::DUPLICATED_KEY, source_mark(mark));
+        }
+
+        key_->parent_ = node->parent_ = data_;
+        map.emplace_back(std::move(key_), node);
+        key_turn_ = true;
+    }
+
+} // namespace cyaml
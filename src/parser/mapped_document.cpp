@@ -0,0 +1,192 @@
+/**
+ * @file        mapped_document.cpp
+ * @brief       映射到内存的只读快照
+ * @details     主要包含 Mapped_Node、Mapped_Document 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/mapped_document.h"
+#include "cyaml/error/error_msgs.h"
+#include "cyaml/error/exceptions.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cyaml
+{
+    Mapped_Node::Mapped_Node(const char *body, size_t limit, uint32_t offset)
+        : body_(body), limit_(limit), offset_(offset)
+    {
+        Snapshot_Record record;
+        if (offset > limit || sizeof(record) > limit - offset)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        std::memcpy(&record, body + offset, sizeof(record));
+        type_ = static_cast<Node_Type>(record.type);
+        style_ = static_cast<Node_Style>(record.style);
+        size_ = record.size;
+        if (record.style > static_cast<uint8_t>(Node_Style::FLOW))
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        // 节点内容需要完整位于数据区中，损坏的条目数在计算索引前排除
+        size_t rest = limit - offset - sizeof(record);
+        size_t content = 0;
+        if (is_scalar()) {
+            content = size_;
+        } else if (is_seq()) {
+            content = size_t(size_) * sizeof(uint32_t);
+        } else if (is_map()) {
+            if (size_ > rest / (2 * sizeof(uint32_t)))
+                throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+            content = size_t(size_) * 2 * sizeof(uint32_t) +
+                      size_t(snapshot_index_capacity(size_)) *
+                              sizeof(Snapshot_Slot);
+        } else if (!is_null()) {
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+        }
+
+        if (content > rest)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+    }
+
+    Mapped_Node Mapped_Node::operator[](uint32_t index) const
+    {
+        if (!is_seq() || index >= size_)
+            throw Dereference_Exception();
+
+        return child(index);
+    }
+
+    Mapped_Node Mapped_Node::operator[](std::string_view key) const
+    {
+        if (!is_map())
+            throw Dereference_Exception();
+
+        uint32_t entry = find(key);
+        if (entry == size_)
+            throw Dereference_Exception();
+
+        return child(2 * size_t(entry) + 1);
+    }
+
+    Mapped_Node Mapped_Node::key(uint32_t index) const
+    {
+        if (!is_map() || index >= size_)
+            throw Dereference_Exception();
+
+        return child(2 * size_t(index));
+    }
+
+    Mapped_Node Mapped_Node::value(uint32_t index) const
+    {
+        if (!is_map() || index >= size_)
+            throw Dereference_Exception();
+
+        return child(2 * size_t(index) + 1);
+    }
+
+    Mapped_Node Mapped_Node::child(size_t slot) const
+    {
+        uint32_t offset;
+        std::memcpy(
+                &offset,
+                body_ + offset_ + sizeof(Snapshot_Record) +
+                        slot * sizeof(uint32_t),
+                sizeof(offset));
+
+        // 子节点总是位于父节点之后，损坏的快照不会形成环
+        if (offset <= offset_)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        return Mapped_Node(body_, limit_, offset);
+    }
+
+    uint32_t Mapped_Node::find(std::string_view key) const
+    {
+        if (!is_map())
+            return size_;
+
+        uint32_t capacity = snapshot_index_capacity(size_);
+        if (capacity == 0) {
+            for (uint32_t entry = 0; entry < size_; entry++) {
+                if (key_equal(entry, key))
+                    return entry;
+            }
+            return size_;
+        }
+
+        // 先比较索引中的哈希，哈希相同时再读取键
+        const char *index = body_ + offset_ + sizeof(Snapshot_Record) +
+                            size_t(size_) * 2 * sizeof(uint32_t);
+        uint32_t hash = snapshot_key_hash(key);
+        for (uint32_t n = 0, i = hash & (capacity - 1); n < capacity;
+             n++, i = (i + 1) & (capacity - 1)) {
+            Snapshot_Slot slot;
+            std::memcpy(&slot, index + i * sizeof(slot), sizeof(slot));
+            if (slot.entry == 0)
+                break;
+
+            if (slot.hash == hash && slot.entry <= size_ &&
+                key_equal(slot.entry - 1, key)) {
+                return slot.entry - 1;
+            }
+        }
+
+        return size_;
+    }
+
+    bool Mapped_Node::key_equal(uint32_t entry, std::string_view key) const
+    {
+        Mapped_Node node = child(2 * size_t(entry));
+        return node.is_scalar() && node.scalar_view() == key;
+    }
+
+    Mapped_Document::Mapped_Document(const std::string &file, bool verify)
+    {
+        int fd = ::open(file.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw Exception("Failed to open \"" + file + "\"", Mark());
+        }
+
+        length_ = st.st_size;
+        if (length_ < sizeof(Snapshot_Header)) {
+            ::close(fd);
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+        }
+
+        // 映射建立后可以关闭文件描述符
+        void *map = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            throw Exception("Failed to map \"" + file + "\"", Mark());
+        map_ = map;
+
+        Snapshot_Header head;
+        try {
+            head = read_snapshot_header(
+                    std::string_view(static_cast<char *>(map_), length_),
+                    verify);
+        } catch (...) {
+            ::munmap(map_, length_);
+            throw;
+        }
+
+        body_ = static_cast<char *>(map_) + sizeof(head);
+        size_ = head.size;
+    }
+
+    Mapped_Document::~Mapped_Document()
+    {
+        if (map_)
+            ::munmap(map_, length_);
+    }
+
+} // namespace cyaml
@@ -10,7 +10,15 @@
 
 namespace cyaml
 {
-    Node_Builder::Node_Builder() {}
+    Node_Builder::Node_Builder(
+            std::pmr::memory_resource *resource,
+            Intern_Mode mode,
+            Key_Table *key_table)
+        : resource_(resource), key_table_(key_table)
+    {
+        if (mode != Intern_Mode::NONE)
+            intern_ = std::make_unique<Intern_Table>(mode, resource);
+    }
 
     void Node_Builder::on_document_end()
     {
@@ -23,8 +31,8 @@ namespace cyaml
             Node_Style style)
     {
         mark_ = mark;
-        auto node = std::make_shared<Node>(Node_Type::MAP);
-        nodes_.push(node);
+        auto node = make_node(Node_Type::MAP);
+        push_node(node);
         node->set_style(style);
 
         if (!anchor.empty()) {
@@ -43,8 +51,8 @@ namespace cyaml
             Node_Style style)
     {
         mark_ = mark;
-        auto node = std::make_shared<Node>(Node_Type::SEQ);
-        nodes_.push(node);
+        auto node = make_node(Node_Type::SEQ);
+        push_node(node);
         node->set_style(style);
 
         if (!anchor.empty()) {
@@ -63,8 +71,14 @@ namespace cyaml
             std::string value)
     {
         mark_ = mark;
-        auto node = std::make_shared<Node>(value);
-        nodes_.push(node);
+        Node_Ptr node;
+        if (key_table_ && in_key())
+            node = key_table_->make_key(value, resource_);
+        else if (intern_)
+            node = intern_->scalar(value);
+        else
+            node = make_pmr_shared<Node>(resource_, value, resource_);
+        push_node(node);
 
         if (!anchor.empty()) {
             anchor_map_[anchor] = node;
@@ -76,8 +90,8 @@ namespace cyaml
     void Node_Builder::on_null(const Mark &mark, std::string anchor)
     {
         mark_ = mark;
-        auto node = std::make_shared<Node>();
-        nodes_.push(node);
+        auto node = intern_ ? intern_->null() : make_node(Node_Type::NONE);
+        push_node(node);
 
         if (!anchor.empty()) {
             anchor_map_[anchor] = node;
@@ -89,13 +103,13 @@ namespace cyaml
     void Node_Builder::on_alias(const Mark &mark, std::string anchor)
     {
         mark_ = mark;
-        auto node = std::make_shared<Node>();
-        nodes_.push(node);
+        auto node = make_node(Node_Type::NONE);
         auto iter = anchor_map_.find(anchor);
         if (iter == anchor_map_.end()) {
             throw Parse_Exception(error_msgs::UNKNOWN_ANCHOR, mark_);
         }
         *node = *(iter->second);
+        push_node(node);
 
         pop_node();
     }
@@ -105,6 +119,23 @@ namespace cyaml
         return *root_;
     }
 
+    void Node_Builder::push_node(const Node_Ptr &node)
+    {
+        nodes_.push(node);
+        if (!intern_ || intern_->mode() != Intern_Mode::SUBTREE)
+            return;
+
+        // 存在锚点时不共享子树，别名节点的哈希不会被使用
+        size_t hash = 0;
+        if (!node->is_null())
+            hash = static_cast<size_t>(node->type_);
+        if (node->is_scalar()) {
+            auto text = node->scalar_view();
+            hash_combine(hash, std::hash<std::string_view>()(text));
+        }
+        hashes_.push(hash);
+    }
+
     void Node_Builder::pop_node()
     {
         assert(!nodes_.empty());
@@ -112,6 +143,17 @@ namespace cyaml
         auto node = nodes_.top();
         nodes_.pop();
 
+        bool hashing = !hashes_.empty();
+        size_t hash = 0;
+        if (hashing) {
+            hash = hashes_.top();
+            hashes_.pop();
+        }
+
+        // 锚点可能形成环，存在锚点时不再共享子树
+        if (hashing && anchor_map_.empty())
+            intern_->subtree(node, hash);
+
         // 根节点
         if (nodes_.empty()) {
             root_ = node;
@@ -121,15 +163,26 @@ namespace cyaml
         // 其他节点
         auto top = nodes_.top();
 
-        if (keys_.find(top) != keys_.end()) {
+        if (keys_.find(top.get()) != keys_.end()) {
             nodes_.pop();
-            keys_.erase(top);
+            keys_.erase(top.get());
             insert(top, node);
+            if (hashing) {
+                size_t key_hash = hashes_.top();
+                hashes_.pop();
+                hash_combine(hashes_.top(), key_hash);
+                hash_combine(hashes_.top(), hash);
+            }
         } else if (top->is_map()) {
-            keys_.insert(node);
+            keys_.insert(node.get());
             nodes_.push(node);
+            if (hashing)
+                hashes_.push(hash);
         } else if (top->is_seq()) {
-            top->push_back(*node);
+            // 直接把构建好的节点挂到父节点下，不再复制
+            top->append(node);
+            if (hashing)
+                hash_combine(hashes_.top(), hash);
         } else {
             assert(false);
         }
@@ -138,11 +191,11 @@ namespace cyaml
     void Node_Builder::insert(Node_Ptr &key, Node_Ptr &value)
     {
         assert(!nodes_.empty());
-        if (nodes_.top()->contain(key)) {
+        if (nodes_.top()->contain(*key)) {
             throw Representation_Exception(error_msgs::DUPLICATED_KEY, mark_);
         }
 
-        nodes_.top()->insert(*key, *value);
+        nodes_.top()->insert(key, value);
     }
 
 } // namespace cyaml
@@ -0,0 +1,181 @@
+/**
+ * @file        output.cpp
+ * @brief       带缓冲的输出
+ * @details     主要包含 Output 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/output.h"
+#include "cyaml/error/exceptions.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace cyaml
+{
+    static constexpr size_t RUN_SIZE = 64;
+
+    static const std::string SPACES(RUN_SIZE, ' ');    // 空格
+    static const std::string NEW_LINES(RUN_SIZE, '\n'); // 换行
+
+    Output::Output(std::ostream &out)
+        : target_(Target::STREAM),
+          stream_(&out),
+          storage_(new char[BUFFER_SIZE])
+    {
+        begin_ = cur_ = storage_.get();
+        end_ = begin_ + BUFFER_SIZE;
+    }
+
+    Output::Output(int fd)
+        : target_(Target::FD), fd_(fd), storage_(new char[BUFFER_SIZE])
+    {
+        begin_ = cur_ = storage_.get();
+        end_ = begin_ + BUFFER_SIZE;
+    }
+
+    Output::Output(std::string &out)
+        : target_(Target::STRING),
+          string_(&out),
+          storage_(new char[BUFFER_SIZE])
+    {
+        begin_ = cur_ = storage_.get();
+        end_ = begin_ + BUFFER_SIZE;
+    }
+
+    Output::Output(char *buffer, size_t capacity)
+        : target_(Target::MEMORY),
+          begin_(buffer),
+          cur_(buffer),
+          end_(buffer + capacity)
+    {
+    }
+
+    Output::~Output()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void Output::write(std::string_view str)
+    {
+        append(str.data(), str.size());
+
+        // 计算位置
+        auto last = str.rfind('\n');
+        if (last == std::string_view::npos) {
+            mark_.column += str.size();
+        } else {
+            mark_.line += std::count(str.begin(), str.end(), '\n');
+            mark_.column = str.size() - last;
+        }
+    }
+
+    void Output::write(char ch)
+    {
+        write_raw(ch);
+        if (ch == '\n') {
+            mark_.line++;
+            mark_.column = 1;
+        } else {
+            mark_.column++;
+        }
+    }
+
+    void Output::write_space(uint32_t count)
+    {
+        mark_.column += count;
+        while (count > 0) {
+            uint32_t n = std::min<uint32_t>(count, RUN_SIZE);
+            append(SPACES.data(), n);
+            count -= n;
+        }
+    }
+
+    void Output::write_new_line(uint32_t count)
+    {
+        if (count == 0)
+            return;
+
+        mark_.line += count;
+        mark_.column = 1;
+        while (count > 0) {
+            uint32_t n = std::min<uint32_t>(count, RUN_SIZE);
+            append(NEW_LINES.data(), n);
+            count -= n;
+        }
+    }
+
+    void Output::flush()
+    {
+        if (target_ == Target::MEMORY || cur_ == begin_)
+            return;
+
+        // 先清空缓冲区，写入失败时不会重复写出
+        size_t size = cur_ - begin_;
+        cur_ = begin_;
+        flushed_ += size;
+        write_target(begin_, size);
+    }
+
+    void Output::spill(const char *data, size_t size)
+    {
+        // 内存写满后只计算长度
+        if (target_ == Target::MEMORY) {
+            size_t n = end_ - cur_;
+            if (n > 0) {
+                std::memcpy(cur_, data, n);
+                cur_ = end_;
+            }
+            dropped_ += size - n;
+            return;
+        }
+
+        flush();
+
+        // 超过缓冲区大小的内容直接写出
+        if (size >= BUFFER_SIZE) {
+            flushed_ += size;
+            write_target(data, size);
+            return;
+        }
+
+        std::memcpy(cur_, data, size);
+        cur_ += size;
+    }
+
+    void Output::write_target(const char *data, size_t size)
+    {
+        switch (target_) {
+        case Target::STREAM:
+            stream_->write(data, size);
+            break;
+        case Target::STRING:
+            string_->append(data, size);
+            break;
+        case Target::MEMORY:
+            break;
+        case Target::FD:
+            while (size > 0) {
+                ssize_t n = ::write(fd_, data, size);
+                if (n < 0 && errno == EINTR)
+                    continue;
+
+                if (n < 0) {
+                    throw Exception(
+                            std::string("Failed to write output: ") +
+                                    std::strerror(errno),
+                            Mark());
+                }
+
+                data += n;
+                size -= n;
+            }
+            break;
+        }
+    }
+
+} // namespace cyaml
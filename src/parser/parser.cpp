@@ -190,6 +190,12 @@ namespace cyaml
 
         // 循环解析 key : value
         while (next_type() != Token_Type::BLOCK_MAP_END) {
+            // 条目必须以 KEY 或 VALUE 开始，否则无法继续向前解析
+            if (next_type() != Token_Type::KEY &&
+                next_type() != Token_Type::VALUE) {
+                throw_unexpected_token();
+            }
+
             // key 部分，默认为 "null"
             bool null = true;
             if (next_type() == Token_Type::KEY) {
@@ -0,0 +1,222 @@
+/**
+ * @file        path_handler.cpp
+ * @brief       在事件流中匹配路径
+ * @details     包含 Path_Handler 事件定义
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/path_handler.h"
+
+namespace cyaml
+{
+    Path_Handler::Path_Handler(
+            Selector selector,
+            Callback callback,
+            std::pmr::memory_resource *resource)
+        : selector_(std::move(selector)),
+          callback_(std::move(callback)),
+          builder_(resource)
+    {
+    }
+
+    void Path_Handler::on_document_start(const Mark &mark)
+    {
+        frames_.clear();
+        capture_ = 0;
+        skip_ = 0;
+        skip_key_ = false;
+        builder_.on_document_start(mark);
+    }
+
+    void Path_Handler::on_document_end()
+    {
+        builder_.on_document_end();
+    }
+
+    void Path_Handler::on_map_start(
+            const Mark &mark,
+            std::string anchor,
+            Node_Style style)
+    {
+        if (begin_collection(true)) {
+            builder_.on_map_start(mark, std::move(anchor), style);
+        }
+    }
+
+    void Path_Handler::on_map_end()
+    {
+        if (end_collection()) {
+            builder_.on_map_end();
+            if (--capture_ == 0)
+                deliver();
+        }
+    }
+
+    void Path_Handler::on_seq_start(
+            const Mark &mark,
+            std::string anchor,
+            Node_Style style)
+    {
+        if (begin_collection(false)) {
+            builder_.on_seq_start(mark, std::move(anchor), style);
+        }
+    }
+
+    void Path_Handler::on_seq_end()
+    {
+        if (end_collection()) {
+            builder_.on_seq_end();
+            if (--capture_ == 0)
+                deliver();
+        }
+    }
+
+    void Path_Handler::on_scalar(
+            const Mark &mark,
+            std::string anchor,
+            std::string value)
+    {
+        if (scalar_node(&value)) {
+            builder_.on_scalar(mark, std::move(anchor), std::move(value));
+            if (capture_ == 0)
+                deliver();
+        }
+    }
+
+    void Path_Handler::on_null(const Mark &mark, std::string anchor)
+    {
+        if (scalar_node(nullptr)) {
+            builder_.on_null(mark, std::move(anchor));
+            if (capture_ == 0)
+                deliver();
+        }
+    }
+
+    void Path_Handler::on_alias(const Mark &mark, std::string anchor)
+    {
+        if (scalar_node(nullptr)) {
+            builder_.on_alias(mark, std::move(anchor));
+            if (capture_ == 0)
+                deliver();
+        }
+    }
+
+    const Path_Handler::Location &Path_Handler::location()
+    {
+        location_.clear();
+        for (auto &frame : frames_) {
+            Path_Component component;
+            if (frame.is_map) {
+                component.key = frame.key;
+                component.valid = frame.key_valid;
+            } else {
+                component.index = frame.index;
+            }
+            location_.push_back(component);
+        }
+
+        return location_;
+    }
+
+    bool Path_Handler::begin_collection(bool is_map)
+    {
+        if (capture_) {
+            capture_++;
+            return true;
+        }
+
+        if (skip_) {
+            skip_++;
+            return false;
+        }
+
+        // 集合作为键时无法按路径匹配，整体跳过
+        if (in_key()) {
+            skip_ = 1;
+            skip_key_ = true;
+            return false;
+        }
+
+        auto &location = this->location();
+        if (match(location)) {
+            capture_ = 1;
+            return true;
+        }
+
+        if (!prefix(location)) {
+            skip_ = 1;
+            return false;
+        }
+
+        frames_.push_back({is_map, true, false, {}, 0});
+        return false;
+    }
+
+    bool Path_Handler::end_collection()
+    {
+        if (capture_)
+            return true;
+
+        if (skip_) {
+            if (--skip_ > 0)
+                return false;
+
+            if (skip_key_) {
+                skip_key_ = false;
+                frames_.back().key_turn = false;
+                frames_.back().key_valid = false;
+            } else {
+                next();
+            }
+            return false;
+        }
+
+        frames_.pop_back();
+        next();
+        return false;
+    }
+
+    bool Path_Handler::scalar_node(std::string *key)
+    {
+        if (capture_)
+            return true;
+
+        if (skip_)
+            return false;
+
+        if (in_key()) {
+            auto &frame = frames_.back();
+            frame.key_turn = false;
+            frame.key_valid = key != nullptr;
+            if (key)
+                frame.key = std::move(*key);
+            return false;
+        }
+
+        if (match(location()))
+            return true;
+
+        next();
+        return false;
+    }
+
+    void Path_Handler::next()
+    {
+        if (frames_.empty())
+            return;
+
+        auto &frame = frames_.back();
+        if (frame.is_map) {
+            frame.key_turn = true;
+        } else {
+            frame.index++;
+        }
+    }
+
+    void Path_Handler::deliver()
+    {
+        callback_(location_, builder_.root());
+        next();
+    }
+
+} // namespace cyaml
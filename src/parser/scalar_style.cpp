@@ -0,0 +1,323 @@
+/**
+ * @file        scalar_style.cpp
+ * @brief       输出标量时选择引号和转义
+ * @details     主要包含标量输出风格的判断和带转义的输出函数实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/scalar_style.h"
+#include <cstdint>
+#include <cstring>
+
+namespace cyaml
+{
+    static constexpr uint64_t ONES = 0x0101010101010101ULL;
+    static constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+
+    /**
+     * @brief   判断 8 个字节中是否有小于 n 的字节，n 不超过 128
+     * @param   word    8 个字节
+     * @param   n       上界
+     * @return  uint64_t    不为 0 时存在
+     */
+    static inline uint64_t has_less(uint64_t word, unsigned char n)
+    {
+        return (word - ONES * n) & ~word & HIGHS;
+    }
+
+    /**
+     * @brief   判断 8 个字节中是否有等于 c 的字节
+     * @param   word    8 个字节
+     * @param   c       字符
+     * @return  uint64_t    不为 0 时存在
+     */
+    static inline uint64_t has_byte(uint64_t word, unsigned char c)
+    {
+        return has_less(word ^ (ONES * c), 1);
+    }
+
+    /**
+     * @brief   查找下一个需要处理的字符
+     * @details 先每次检查 8 个字节，遇到含有需要处理的字符的一组后
+     *          再逐个字符判断
+     * @param   str     字符串
+     * @param   pos     起始位置
+     * @param   word    判断 8 个字节中是否有需要处理的字符
+     * @param   byte    判断单个字符是否需要处理
+     * @return  size_t  字符位置，没有时返回字符串长度
+     */
+    template <typename Word, typename Byte>
+    static size_t find_next(
+            std::string_view str,
+            size_t pos,
+            Word word,
+            Byte byte)
+    {
+        const char *data = str.data();
+        while (pos + sizeof(uint64_t) <= str.size()) {
+            uint64_t value;
+            std::memcpy(&value, data + pos, sizeof(value));
+            if (word(value))
+                break;
+            pos += sizeof(uint64_t);
+        }
+
+        while (pos < str.size() &&
+               !byte(static_cast<unsigned char>(data[pos]))) {
+            pos++;
+        }
+
+        return pos;
+    }
+
+    /**
+     * @brief   判断是否为控制字符
+     * @param   c   字符
+     * @return  bool
+     */
+    static inline bool is_control(unsigned char c)
+    {
+        return c < 0x20 || c == 0x7f;
+    }
+
+    /**
+     * @brief   判断是否为流式集合的指示符
+     * @param   c   字符
+     * @return  bool
+     */
+    static inline bool is_flow_indicator(unsigned char c)
+    {
+        return c == ',' || c == '[' || c == ']' || c == '{' || c == '}';
+    }
+
+    /**
+     * @brief   判断在双引号中是否需要转义
+     * @param   c   字符
+     * @return  bool
+     */
+    static inline bool need_escape(unsigned char c)
+    {
+        return is_control(c) || c == '"' || c == '\\';
+    }
+
+    Scalar_Style classify_scalar(std::string_view str, Scalar_Context context)
+    {
+        // 与空值混淆的标量
+        if (str.empty() || str == "~" || str == "null")
+            return Scalar_Style::DOUBLE_QUOTED;
+
+        bool flow = context == Scalar_Context::FLOW;
+        bool plain = true;
+        bool new_line = false;
+        bool control = false;
+        bool quote = false;
+        bool literal = context == Scalar_Context::BLOCK;
+
+        // 指示符开头，- ? : 后跟空格时才是指示符
+        unsigned char first = str.front();
+        if (std::string_view(",[]{}#&*!|>'\"%@`").find(first) !=
+            std::string_view::npos) {
+            plain = false;
+        } else if (
+                (first == '-' || first == '?' || first == ':') &&
+                (str.size() == 1 || str[1] == ' ')) {
+            plain = false;
+        }
+
+        // 与文档标记相同的开头
+        if (str.substr(0, 3) == "---" || str.substr(0, 3) == "...")
+            plain = false;
+
+        // 首尾空白会被忽略
+        if (first == ' ' || str.back() == ' ') {
+            plain = false;
+            literal = false;
+        }
+
+        // 块字面量不能以空行开头，# 开头的行会被当作注释
+        if (first == '\n' || first == '#')
+            literal = false;
+
+        // 块字面量最多保留末尾的一个换行
+        if (str.size() >= 2 && str.substr(str.size() - 2) == "\n\n")
+            literal = false;
+
+        auto word = [flow](uint64_t value) {
+            uint64_t found = has_less(value, 0x20) | has_byte(value, 0x7f) |
+                             has_byte(value, '\'') | has_byte(value, ':') |
+                             has_byte(value, '#');
+            if (flow) {
+                found |= has_byte(value, ',') | has_byte(value, '[') |
+                         has_byte(value, ']') | has_byte(value, '{') |
+                         has_byte(value, '}');
+            }
+            return found != 0;
+        };
+        auto byte = [flow](unsigned char c) {
+            return is_control(c) || c == '\'' || c == ':' || c == '#' ||
+                   (flow && is_flow_indicator(c));
+        };
+
+        for (size_t i = find_next(str, 0, word, byte); i < str.size();
+             i = find_next(str, i + 1, word, byte)) {
+            unsigned char c = str[i];
+            if (c == '\n') {
+                new_line = true;
+                plain = false;
+
+                // 块字面量会去掉多余的缩进和行尾空白
+                if (i > 0 && str[i - 1] == ' ')
+                    literal = false;
+                if (i + 1 < str.size() &&
+                    (str[i + 1] == ' ' || str[i + 1] == '#')) {
+                    literal = false;
+                }
+            } else if (is_control(c)) {
+                control = true;
+                plain = false;
+            } else if (c == '\'') {
+                quote = true;
+            } else if (c == ':') {
+                if (i + 1 == str.size() || str[i + 1] == ' ')
+                    plain = false;
+            } else if (c == '#') {
+                if (i > 0 && str[i - 1] == ' ')
+                    plain = false;
+            } else {
+                plain = false;
+            }
+        }
+
+        if (plain)
+            return Scalar_Style::PLAIN;
+        if (new_line && !control && literal)
+            return Scalar_Style::LITERAL;
+        if (!new_line && !control && !quote)
+            return Scalar_Style::SINGLE_QUOTED;
+        return Scalar_Style::DOUBLE_QUOTED;
+    }
+
+    void write_scalar(
+            Output &out,
+            std::string_view str,
+            Scalar_Context context,
+            uint32_t indent,
+            bool raw)
+    {
+        switch (classify_scalar(str, context)) {
+        case Scalar_Style::PLAIN:
+            raw ? out.write_raw(str) : out.write(str);
+            break;
+        case Scalar_Style::SINGLE_QUOTED:
+            raw ? out.write_raw('\'') : out.write('\'');
+            raw ? out.write_raw(str) : out.write(str);
+            raw ? out.write_raw('\'') : out.write('\'');
+            break;
+        case Scalar_Style::DOUBLE_QUOTED:
+            write_double_quoted(out, str, false, raw);
+            break;
+        case Scalar_Style::LITERAL:
+            // 末尾的换行由块字面量的风格表示
+            if (str.back() == '\n') {
+                out.write('|');
+                str.remove_suffix(1);
+            } else {
+                out.write("|-");
+            }
+
+            for (size_t begin = 0; begin <= str.size();) {
+                size_t end = str.find('\n', begin);
+                if (end == std::string_view::npos)
+                    end = str.size();
+
+                out.write_new_line();
+                if (end > begin) {
+                    out.write_space(indent);
+                    out.write(str.substr(begin, end - begin));
+                }
+                begin = end + 1;
+            }
+            break;
+        }
+    }
+
+    void write_double_quoted(
+            Output &out,
+            std::string_view str,
+            bool json,
+            bool raw)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        auto write = [&](std::string_view s) {
+            raw ? out.write_raw(s) : out.write(s);
+        };
+        auto word = [](uint64_t value) {
+            return (has_less(value, 0x20) | has_byte(value, 0x7f) |
+                    has_byte(value, '"') | has_byte(value, '\\')) != 0;
+        };
+
+        write("\"");
+
+        // 不需要转义的部分整段写入
+        size_t begin = 0;
+        for (size_t i = find_next(str, 0, word, need_escape); i < str.size();
+             i = find_next(str, begin, word, need_escape)) {
+            write(str.substr(begin, i - begin));
+            begin = i + 1;
+
+            unsigned char c = str[i];
+            char escape = 0;
+            switch (c) {
+            case '"':
+                escape = '"';
+                break;
+            case '\\':
+                escape = '\\';
+                break;
+            case '\b':
+                escape = 'b';
+                break;
+            case '\f':
+                escape = 'f';
+                break;
+            case '\n':
+                escape = 'n';
+                break;
+            case '\r':
+                escape = 'r';
+                break;
+            case '\t':
+                escape = 't';
+                break;
+            case '\0':
+                escape = json ? 0 : '0';
+                break;
+            case '\a':
+                escape = json ? 0 : 'a';
+                break;
+            case '\v':
+                escape = json ? 0 : 'v';
+                break;
+            case '\x1b':
+                escape = json ? 0 : 'e';
+                break;
+            }
+
+            if (escape) {
+                char code[] = {'\\', escape};
+                write(std::string_view(code, sizeof(code)));
+            } else if (json) {
+                char code[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                write(std::string_view(code, sizeof(code)));
+            } else {
+                char code[] = {'\\', 'x', hex[c >> 4], hex[c & 0xf]};
+                write(std::string_view(code, sizeof(code)));
+            }
+        }
+        write(str.substr(begin));
+
+        write("\"");
+    }
+
+} // namespace cyaml
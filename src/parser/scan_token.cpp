@@ -23,6 +23,9 @@ namespace cyaml
     {
         can_be_json_ = false;
 
+        // 新文档开始时结束上一文档中所有未闭合的 block 集合
+        pop_all_indent();
+
         for (auto i = 0; i < 3; i++) {
             next_char();
         }
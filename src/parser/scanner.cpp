@@ -153,6 +153,30 @@ namespace cyaml
             return iter->second;
         }
 
+        // \xXX 表示单个字节
+        if (input_.peek() == 'x') {
+            next_char();
+            int value = 0;
+            for (int i = 0; i < 2; i++) {
+                char c = input_.peek();
+                int digit = -1;
+                if (c >= '0' && c <= '9')
+                    digit = c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    digit = c - 'A' + 10;
+
+                if (digit < 0) {
+                    throw Parse_Exception(
+                            error_msgs::UNKNOWN_ESCAPE, input_.mark());
+                }
+                value = value * 16 + digit;
+                next_char();
+            }
+            return static_cast<char>(value);
+        }
+
         throw Parse_Exception(error_msgs::UNKNOWN_ESCAPE, input_.mark());
     }
 
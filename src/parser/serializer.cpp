@@ -6,170 +6,886 @@
  */
 
 #include "cyaml/parser/serializer.h"
+#include "cyaml/error/error_msgs.h"
+#include "cyaml/error/exceptions.h"
 #include <algorithm>
-#include <unistd.h>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace cyaml
 {
-    Serializer::Serializer(std::ostream &out): output_stream_(out) {}
+    static constexpr size_t CHUNKS_PER_THREAD = 4; // 多线程输出时每个线程的段数
 
-    void Serializer::serialize(const Node &node)
+    /**
+     * @enum    Frame_Kind
+     * @brief   集合的输出方式
+     */
+    enum class Serializer::Frame_Kind : uint8_t
     {
-        write_node(node, 0);
-    }
+        BLOCK,  // 块集合
+        FLOW,   // 流式集合
+        COMPACT // FLOW 或 JSON 格式，不计算行列
+    };
 
-    void Serializer::fill_blank(uint32_t indent)
+    /**
+     * @struct  Frame
+     * @brief   正在输出的集合
+     */
+    struct Serializer::Frame
     {
-        if (column() < indent + 1) {
-            write_space(indent + 1 - column());
+        Node::const_iterator iter; // 正在输出的条目
+        Node::const_iterator end;  // 最后一个条目之后
+        uint32_t indent;           // 块集合的缩进
+        Frame_Kind kind;           // 输出方式
+        bool map;                  // 是否为 map
+        bool leading;              // 下一个条目是否为第一个条目
+        bool key_done;             // map 当前条目的键是否已输出
+        bool close;                // 结束时是否输出括号
+    };
+
+    /**
+     * @class   Frame_Stack
+     * @brief   正在输出的集合栈
+     * @details 嵌套较浅时使用内部数组，不分配内存
+     */
+    class Serializer::Frame_Stack
+    {
+    private:
+        static constexpr uint32_t INLINE_SIZE = 32; // 内部数组长度
+
+        Frame inline_[INLINE_SIZE];   // 内部数组
+        std::unique_ptr<Frame[]> heap_; // 超过内部数组时分配的空间
+        Frame *frames_ = inline_;       // 当前使用的空间
+        uint32_t size_ = 0;             // 集合个数
+        uint32_t capacity_ = INLINE_SIZE;
+
+    public:
+        /**
+         * @brief   判断栈是否为空
+         * @return  bool
+         */
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        /**
+         * @brief   获取栈中集合个数，即当前嵌套层数
+         * @return  uint32_t
+         */
+        uint32_t size() const
+        {
+            return size_;
         }
-    }
 
-    void Serializer::write(std::string str)
+        /**
+         * @brief   获取栈顶集合，入栈后原有引用失效
+         * @return  Frame &
+         */
+        Frame &top()
+        {
+            return frames_[size_ - 1];
+        }
+
+        /**
+         * @brief   弹出栈顶集合
+         * @return  void
+         */
+        void pop()
+        {
+            size_--;
+        }
+
+        /**
+         * @brief   压入集合，内部数组用完后按两倍扩容
+         * @param   frame   集合
+         * @return  void
+         */
+        void push(const Frame &frame)
+        {
+            if (size_ == capacity_) {
+                auto heap = std::make_unique<Frame[]>(capacity_ * 2);
+                std::copy(frames_, frames_ + size_, heap.get());
+                heap_ = std::move(heap);
+                frames_ = heap_.get();
+                capacity_ *= 2;
+            }
+            frames_[size_++] = frame;
+        }
+    };
+
+    /**
+     * @brief   判断是否符合 JSON 数字格式
+     * @details -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][-+]?[0-9]+)?
+     * @param   str     字符串
+     * @return  bool
+     */
+    static bool is_json_number(std::string_view str)
     {
-        output_stream_ << str;
+        auto digits = [&](size_t &i) {
+            size_t begin = i;
+            while (i < str.size() && str[i] >= '0' && str[i] <= '9')
+                i++;
+            return i - begin;
+        };
 
-        // 计算位置
-        int line_cnt = std::count(str.begin(), str.end(), '\n');
-        int column_cnt;
+        size_t i = 0;
+        if (i < str.size() && str[i] == '-')
+            i++;
 
-        if (line_cnt == 0) {
-            column_cnt = str.size();
-        } else {
-            mark_.column = 1;
-            column_cnt = str.size() - 1 - str.find_last_of('\n');
+        size_t begin = i;
+        size_t count = digits(i);
+        if (count == 0 || (count > 1 && str[begin] == '0'))
+            return false;
+
+        if (i < str.size() && str[i] == '.') {
+            i++;
+            if (digits(i) == 0)
+                return false;
+        }
+
+        if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+            i++;
+            if (i < str.size() && (str[i] == '-' || str[i] == '+'))
+                i++;
+            if (digits(i) == 0)
+                return false;
         }
 
-        mark_.line += line_cnt;
-        mark_.column += column_cnt;
+        return i == str.size();
     }
 
-    void Serializer::write_space(int count)
+    Serializer::Serializer(std::ostream &out, Dump_Format format)
+        : output_(out), format_(format)
     {
-        assert(count >= 0);
-        write(std::string(count, ' '));
     }
 
-    void Serializer::write_new_line(int count)
+    Serializer::Serializer(int fd, Dump_Format format)
+        : output_(fd), format_(format)
     {
-        assert(count >= 0);
-        write(std::string(count, '\n'));
     }
 
-    void Serializer::write_node(const Node &node, uint32_t indent)
+    Serializer::Serializer(std::string &out, Dump_Format format)
+        : output_(out), format_(format)
     {
-        if (node.style() == Node_Style::BLOCK) {
-            write_block_node(node, indent);
+    }
+
+    Serializer::Serializer(char *buffer, size_t capacity, Dump_Format format)
+        : output_(buffer, capacity), format_(format)
+    {
+    }
+
+    void Serializer::serialize(const Node &node)
+    {
+        Frame_Kind kind = format_ != Dump_Format::YAML ? Frame_Kind::COMPACT
+                                                       : Frame_Kind::BLOCK;
+        if (node.is_collection()) {
+            Frame_Stack stack;
+            push_collection(stack, node, kind, 0);
+            write_frames(stack);
         } else {
-            write_flow_node(node);
+            write_leaf(node, kind, 0);
         }
+        output_.flush();
     }
 
-    void Serializer::write_block_node(const Node &node, uint32_t indent)
+    void Serializer::serialize_parallel(const Node &node, size_t threads)
     {
-        if (node.is_null()) {
-            write("null");
-        } else if (node.is_map()) {
-            write_block_map(node, indent);
-        } else if (node.is_seq()) {
-            write_block_seq(node, indent);
-        } else if (node.is_scalar()) {
-            std::string str = node.scalar();
-            if (str.empty() || str == "~" || str == "null") {
-                str = '"' + str + '"';
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+
+        // 只有冻结的节点树可以被多个线程同时读取
+        if (threads <= 1 || !node.is_frozen() || !node.is_collection() ||
+            node.size() < 2 || column() != 1) {
+            serialize(node);
+            return;
+        }
+
+        // 每个线程分到多段，避免条目大小不均时等待
+        size_t size = node.size();
+        size_t count = std::min(size, threads * CHUNKS_PER_THREAD);
+        std::vector<Node::const_iterator> bounds;
+        bounds.reserve(count + 1);
+        auto iter = node.begin();
+        for (size_t i = 0, pos = 0; i < count; i++) {
+            for (size_t next = size * i / count; pos < next; pos++)
+                ++iter;
+            bounds.push_back(iter);
+        }
+        bounds.push_back(node.end());
+
+        bool compact = format_ != Dump_Format::YAML;
+        bool flow = compact || node.style() == Node_Style::FLOW;
+
+        std::vector<std::string> chunks(count);
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::exception_ptr error;
+        auto work = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                try {
+                    Serializer serializer(chunks[i], format_);
+                    serializer.max_depth_ = max_depth_;
+                    serializer.write_entries(
+                            node, bounds[i], bounds[i + 1], i == 0, flow, 0);
+                    serializer.output_.flush();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < std::min(threads, count); i++)
+            workers.emplace_back(work);
+        work();
+        for (auto &worker : workers)
+            worker.join();
+
+        if (error)
+            std::rethrow_exception(error);
+
+        // 每段都从行首开始输出，块集合的条目不以换行结束时按单线程输出
+        if (!flow) {
+            for (size_t i = 0; i + 1 < count; i++) {
+                if (chunks[i].empty() || chunks[i].back() != '\n') {
+                    serialize(node);
+                    return;
+                }
             }
-            write(str);
         }
+
+        char open = node.is_map() ? '{' : '[';
+        char close = node.is_map() ? '}' : ']';
+        if (flow)
+            compact ? output_.write_raw(open) : output_.write(open);
+        for (auto &chunk : chunks) {
+            compact ? output_.write_raw(chunk) : output_.write(chunk);
+            std::string().swap(chunk);
+        }
+        if (flow)
+            compact ? output_.write_raw(close) : output_.write(close);
+        output_.flush();
     }
 
-    void Serializer::write_flow_node(const Node &node)
+    void Serializer::serialize_preserved(const Node &node)
     {
-        if (node.is_null()) {
-            write("null");
-        } else if (node.is_map()) {
-            write_flow_map(node);
-        } else if (node.is_seq()) {
-            write_flow_seq(node);
-        } else if (node.is_scalar()) {
-            std::string str = node.scalar();
-            if (str.empty() || str == "~" || str == "null") {
-                str = '"' + str + '"';
+        // 清空后的集合需要输出 {} 或 []，不能保留原来的条目
+        auto *state = node.data_->tracked;
+        auto *span = state ? state->span.get() : nullptr;
+        if (format_ != Dump_Format::YAML || !span || !span->root ||
+            !node.is_collection() || node.style() != Node_Style::BLOCK ||
+            node.size() == 0) {
+            serialize(node);
+            return;
+        }
+
+        // 根节点之前的注释和文档标记，以及之后的其它文档原样保留
+        write_source(*span, 0, span->begin);
+        write_preserved(node, 0);
+        write_source(*span, span->entries.back(), span->buffer->size());
+        output_.flush();
+    }
+
+    /**
+     * @brief   查找条目末尾的整行注释和空行
+     * @details 只有列号不大于条目的注释才一定不是条目内容的一部分，
+     *          条目重新输出后仍保留这些行
+     * @param   text    源数据
+     * @param   begin   条目起始偏移
+     * @param   end     条目结束偏移
+     * @param   column  条目的列号
+     * @return  uint32_t
+     */
+    static uint32_t entry_tail(
+            const std::string &text,
+            uint32_t begin,
+            uint32_t end,
+            uint32_t column)
+    {
+        uint32_t tail = end;
+        while (tail > begin) {
+            // 前一行的范围，不包括换行
+            uint32_t last = text[tail - 1] == '\n' ? tail - 1 : tail;
+            uint32_t line = last;
+            while (line > begin && text[line - 1] != '\n')
+                line--;
+
+            // 条目的第一行不属于末尾
+            if (line <= begin)
+                break;
+
+            uint32_t pos = line;
+            while (pos < last && text[pos] == ' ')
+                pos++;
+
+            bool blank = pos == last || text[pos] == '\r';
+            bool comment =
+                    pos < last && text[pos] == '#' && pos - line < column;
+            if (!blank && !comment)
+                break;
+
+            tail = line;
+        }
+
+        return tail;
+    }
+
+    void Serializer::move_to(uint32_t target)
+    {
+        if (column() > target)
+            output_.write_new_line();
+        fill_blank(target - 1);
+    }
+
+    void Serializer::write_source(
+            const Lazy_Range &range,
+            uint32_t begin,
+            uint32_t end)
+    {
+        if (begin < end) {
+            auto *text = range.buffer->data();
+            output_.write(std::string_view(text + begin, end - begin));
+        }
+    }
+
+    void Serializer::write_preserved(const Node &node, uint32_t depth)
+    {
+        if (depth >= max_depth_)
+            throw Representation_Exception(error_msgs::TOO_DEEP, Mark());
+
+        // 尚未构建的集合没有被修改过
+        auto &state = *node.data_->tracked;
+        if (state.lazy) {
+            write_source(*state.lazy, state.lazy->begin, state.lazy->end);
+            return;
+        }
+
+        auto &span = *state.span;
+        auto &entries = span.entries;
+        uint32_t count = entries.size() - 1;
+        uint32_t indent = span.column - 1;
+        bool map = node.is_map();
+
+        uint32_t index = 0;
+        for (auto iter = node.begin(); iter != node.end(); ++iter, ++index) {
+            auto next = iter;
+            ++next;
+
+            // 集合未修改时条目与源数据一一对应，否则由子节点找到原来的条目
+            const Node &value = iter.value();
+            const Node &first = map ? iter.key() : value;
+            uint32_t entry = count;
+            if (!state.modified)
+                entry = index;
+            else if (auto *origin = first.data_->source_state(&first))
+                entry = origin->entry;
+
+            move_to(span.column);
+            if (entry >= count) {
+                write_entries(node, iter, next, false, false, indent);
+                continue;
+            }
+
+            // 条目的范围不包括下一个条目的缩进
+            uint32_t begin = entries[entry];
+            uint32_t end = entry + 1 < count ? entries[entry + 1] - indent
+                                             : entries[count];
+
+            if (!map || unchanged(iter.key())) {
+                if (auto *range = source_range(value)) {
+                    write_source(span, begin, range->begin);
+                    write_preserved(value, depth + 1);
+                    write_source(span, range->end, end);
+                    continue;
+                }
+
+                if (unchanged(value)) {
+                    write_source(span, begin, end);
+                    continue;
+                }
             }
-            write(str);
+
+            write_entries(node, iter, next, false, false, indent);
+            write_source(
+                    span, entry_tail(*span.buffer, begin, end, span.column),
+                    end);
         }
     }
 
-    void Serializer::write_block_map(const Node &node, uint32_t indent)
+    const Lazy_Range *Serializer::source_range(const Node &node)
     {
-        for (auto &i : node.keys()) {
-            write_key(i, indent);
-            write_value(node[i], indent);
+        auto &data = *node.data_;
+        auto *state = data.source_state(&node);
+        if (!state || !node.is_collection() ||
+            node.style() != Node_Style::BLOCK) {
+            return nullptr;
         }
+
+        if (state->lazy)
+            return state->lazy.get();
+
+        // 清空后的集合需要输出 {} 或 []，不能保留原来的条目
+        if (data.map.empty() && data.seq.empty())
+            return nullptr;
+
+        return state->span.get();
     }
 
-    void Serializer::write_block_seq(const Node &node, uint32_t indent)
+    bool Serializer::unchanged(const Node &node)
     {
-        for (int i = 0; i < node.size(); i++) {
-            fill_blank(indent);
-            write("- ");
-            if (!line_style(node[i])) {
-                write_new_line();
-                write_node(node[i], increase(indent));
-            } else {
-                write_node(node[i], increase(indent));
-                write_new_line();
+        auto &data = *node.data_;
+        auto *state = data.source_state(&node);
+        if (!state || state->modified)
+            return false;
+
+        // 尚未构建的集合没有被修改过
+        if (state->lazy)
+            return true;
+
+        for (auto &[key, value] : data.map) {
+            if (!unchanged(*key) || !unchanged(*value))
+                return false;
+        }
+
+        for (auto &i : data.seq) {
+            if (!unchanged(*i))
+                return false;
+        }
+
+        return true;
+    }
+
+    void Serializer::fill_blank(uint32_t indent)
+    {
+        if (column() < indent + 1) {
+            output_.write_space(indent + 1 - column());
+        }
+    }
+
+    void Serializer::write_scalar(
+            const Node &node,
+            Scalar_Context context,
+            uint32_t indent)
+    {
+        // 根节点的块字面量内容也需要缩进
+        cyaml::write_scalar(
+                output_, node.scalar_view(), context,
+                std::max(indent, indent_inc_));
+    }
+
+    void Serializer::write_entries(
+            const Node &node,
+            Node::const_iterator first,
+            Node::const_iterator last,
+            bool leading,
+            bool flow,
+            uint32_t indent)
+    {
+        Frame_Kind kind = format_ != Dump_Format::YAML ? Frame_Kind::COMPACT
+                          : flow                       ? Frame_Kind::FLOW
+                                                       : Frame_Kind::BLOCK;
+
+        // 只输出条目，不输出集合的括号
+        Frame_Stack stack;
+        stack.push(
+                {first, last, indent, kind, node.is_map(), leading, false,
+                 false});
+        write_frames(stack);
+    }
+
+    void Serializer::write_frames(Frame_Stack &stack)
+    {
+        // 块集合中的流式集合在两种输出方式之间切换
+        while (!stack.empty()) {
+            if (stack.top().kind == Frame_Kind::BLOCK)
+                write_block_entries(stack);
+            else
+                write_flow_entries(stack);
+        }
+    }
+
+    void Serializer::write_block_entries(Frame_Stack &stack)
+    {
+        Frame *frame = &stack.top();
+        auto iter = frame->iter;
+        auto end = frame->end;
+        bool key_done = frame->key_done;
+
+        // 当前集合的状态保存在局部变量中，切换集合时才写回栈
+        while (true) {
+            if (iter == end) {
+                stack.pop();
+                if (stack.empty())
+                    return;
+
+                frame = &stack.top();
+                end_child(*frame, false);
+                iter = frame->iter;
+                end = frame->end;
+                key_done = frame->key_done;
+                continue;
+            }
+
+            const Node &value = iter.value();
+            uint32_t indent = increase(frame->indent);
+            bool line = line_style(value);
+
+            if (!frame->map) {
+                fill_blank(frame->indent);
+                output_.write("- ");
+                if (!line)
+                    output_.write_new_line();
+            } else if (!key_done) {
+                const Node &key = iter.key();
+                fill_blank(frame->indent);
+                if (!line_style(key))
+                    output_.write("? ");
+                if (key.is_collection()) {
+                    frame->iter = iter;
+                    frame->key_done = false;
+                    push_collection(stack, key, Frame_Kind::BLOCK, indent);
+                    return;
+                }
+                if (key.is_scalar())
+                    write_scalar(key, Scalar_Context::KEY, 0);
+                else
+                    write_leaf(key, Frame_Kind::BLOCK, indent);
+            }
+
+            if (frame->map) {
+                fill_blank(frame->indent);
+                output_.write(": ");
+                if (column() > indent + 1 && !line)
+                    output_.write_new_line();
             }
+
+            if (!value.is_collection()) {
+                write_leaf(value, Frame_Kind::BLOCK, indent);
+                output_.write_new_line();
+                key_done = false;
+                ++iter;
+                continue;
+            }
+
+            // 只包含标量的集合直接输出，不入栈
+            if (write_flat(stack, value, Frame_Kind::BLOCK, indent)) {
+                if (line)
+                    output_.write_new_line();
+                key_done = false;
+                ++iter;
+                continue;
+            }
+
+            frame->iter = iter;
+            frame->key_done = frame->map;
+            push_collection(stack, value, Frame_Kind::BLOCK, indent);
+            frame = &stack.top();
+            if (frame->kind != Frame_Kind::BLOCK)
+                return;
+
+            iter = frame->iter;
+            end = frame->end;
+            key_done = false;
         }
     }
 
-    void Serializer::write_flow_map(const Node &node)
+    void Serializer::write_flow_entries(Frame_Stack &stack)
     {
-        write("{");
-        bool first = true;
-        for (auto &i : node.keys()) {
-            if (first) {
-                first = false;
-            } else {
-                write(", ");
+        bool json = format_ == Dump_Format::JSON;
+        Frame *frame = &stack.top();
+        Frame_Kind kind = frame->kind;
+        bool compact = kind == Frame_Kind::COMPACT;
+        auto iter = frame->iter;
+        auto end = frame->end;
+        bool leading = frame->leading;
+        bool key_done = frame->key_done;
+
+        while (true) {
+            if (iter == end) {
+                bool close = frame->close;
+                if (close) {
+                    char bracket = frame->map ? '}' : ']';
+                    if (compact)
+                        output_.write_raw(bracket);
+                    else
+                        output_.write(bracket);
+                }
+
+                stack.pop();
+                if (stack.empty())
+                    return;
+
+                frame = &stack.top();
+                end_child(*frame, close);
+                if (frame->kind != kind)
+                    return;
+
+                iter = frame->iter;
+                end = frame->end;
+                leading = frame->leading;
+                key_done = frame->key_done;
+                continue;
+            }
+
+            // 键是集合时，回到当前集合后从值开始输出
+            if (!key_done) {
+                if (leading) {
+                    leading = false;
+                } else if (compact) {
+                    output_.write_raw(',');
+                } else {
+                    output_.write(", ");
+                }
+
+                if (frame->map) {
+                    const Node &key = iter.key();
+                    if (json) {
+                        write_json_key(key);
+                    } else if (key.is_collection()) {
+                        frame->iter = iter;
+                        frame->leading = false;
+                        frame->key_done = false;
+                        push_collection(stack, key, kind, 0);
+                        frame = &stack.top();
+                        iter = frame->iter;
+                        end = frame->end;
+                        leading = true;
+                        continue;
+                    } else {
+                        write_leaf(key, kind, 0);
+                    }
+
+                    if (!compact)
+                        output_.write(": ");
+                    else
+                        output_.write_raw(json ? ":" : ": ");
+                }
             }
-            write_flow_node(i);
-            write(": ");
-            write_flow_node(i);
+
+            const Node &value = iter.value();
+            if (!value.is_collection()) {
+                write_leaf(value, kind, 0);
+                key_done = false;
+                ++iter;
+                continue;
+            }
+
+            if (write_flat(stack, value, kind, 0)) {
+                key_done = false;
+                ++iter;
+                continue;
+            }
+
+            frame->iter = iter;
+            frame->leading = false;
+            frame->key_done = frame->map;
+            push_collection(stack, value, kind, 0);
+            frame = &stack.top();
+            iter = frame->iter;
+            end = frame->end;
+            leading = true;
+            key_done = false;
         }
-        write("}");
     }
 
-    void Serializer::write_flow_seq(const Node &node)
+    void Serializer::write_leaf(
+            const Node &node,
+            Frame_Kind kind,
+            uint32_t indent)
     {
-        write("[");
-        for (int i = 0; i < node.size(); i++) {
-            if (i > 0) {
-                write(", ");
+        // 流式集合中的节点总是以流式输出
+        if (kind == Frame_Kind::BLOCK && node.style() == Node_Style::FLOW)
+            kind = Frame_Kind::FLOW;
+
+        if (node.is_null()) {
+            if (kind == Frame_Kind::COMPACT)
+                output_.write_raw("null");
+            else
+                output_.write("null");
+        } else if (kind == Frame_Kind::BLOCK) {
+            write_scalar(node, Scalar_Context::BLOCK, indent);
+        } else if (kind == Frame_Kind::FLOW) {
+            write_scalar(node, Scalar_Context::FLOW, 0);
+        } else if (format_ == Dump_Format::JSON) {
+            write_json_scalar(node);
+        } else {
+            cyaml::write_scalar(
+                    output_, node.scalar_view(), Scalar_Context::FLOW, 0,
+                    true);
+        }
+    }
+
+    bool Serializer::write_flat(
+            const Frame_Stack &stack,
+            const Node &node,
+            Frame_Kind kind,
+            uint32_t indent)
+    {
+        if (kind == Frame_Kind::BLOCK && node.style() == Node_Style::FLOW)
+            kind = Frame_Kind::FLOW;
+
+        // 空的块集合仍按原方式输出
+        bool map = node.is_map();
+        auto begin = node.begin();
+        auto end = node.end();
+        if (kind == Frame_Kind::BLOCK && begin == end)
+            return false;
+
+        for (auto iter = begin; iter != end; ++iter) {
+            if (iter.value().is_collection() ||
+                (map && iter.key().is_collection()))
+                return false;
+        }
+
+        if (stack.size() >= max_depth_)
+            throw Representation_Exception(error_msgs::TOO_DEEP, Mark());
+
+        if (kind == Frame_Kind::BLOCK) {
+            uint32_t inner = increase(indent);
+            for (auto iter = begin; iter != end; ++iter) {
+                fill_blank(indent);
+                if (!map) {
+                    output_.write("- ");
+                } else {
+                    const Node &key = iter.key();
+                    if (key.is_scalar())
+                        write_scalar(key, Scalar_Context::KEY, 0);
+                    else
+                        write_leaf(key, kind, inner);
+                    fill_blank(indent);
+                    output_.write(": ");
+                }
+                write_leaf(iter.value(), kind, inner);
+                output_.write_new_line();
+            }
+            return true;
+        }
+
+        bool compact = kind == Frame_Kind::COMPACT;
+        bool json = format_ == Dump_Format::JSON;
+        char open = map ? '{' : '[';
+        char close = map ? '}' : ']';
+        compact ? output_.write_raw(open) : output_.write(open);
+        for (auto iter = begin; iter != end; ++iter) {
+            if (iter != begin)
+                compact ? output_.write_raw(',') : output_.write(", ");
+
+            if (map && json) {
+                write_json_key(iter.key());
+                output_.write_raw(':');
+            } else if (map) {
+                write_leaf(iter.key(), kind, 0);
+                compact ? output_.write_raw(": ") : output_.write(": ");
             }
-            write_flow_node(node[i]);
+            write_leaf(iter.value(), kind, 0);
         }
-        write("]");
+        compact ? output_.write_raw(close) : output_.write(close);
+        return true;
     }
 
-    void Serializer::write_key(const Node &node, uint32_t indent)
+    void Serializer::push_collection(
+            Frame_Stack &stack,
+            const Node &node,
+            Frame_Kind kind,
+            uint32_t indent)
     {
-        fill_blank(indent);
-        if (!line_style(node)) {
-            write("? ");
+        if (stack.size() >= max_depth_)
+            throw Representation_Exception(error_msgs::TOO_DEEP, Mark());
+
+        if (kind == Frame_Kind::BLOCK && node.style() == Node_Style::FLOW)
+            kind = Frame_Kind::FLOW;
+
+        char open = node.is_map() ? '{' : '[';
+        if (kind == Frame_Kind::COMPACT)
+            output_.write_raw(open);
+        else if (kind == Frame_Kind::FLOW)
+            output_.write(open);
+
+        stack.push(
+                {node.begin(), node.end(), indent, kind, node.is_map(), true,
+                 false, kind != Frame_Kind::BLOCK});
+    }
+
+    void Serializer::end_child(Frame &frame, bool flow)
+    {
+        if (frame.map && !frame.key_done) {
+            frame.key_done = true;
+            if (frame.kind == Frame_Kind::FLOW)
+                output_.write(": ");
+            else if (frame.kind == Frame_Kind::COMPACT)
+                output_.write_raw(": ");
+            return;
         }
-        write_node(node, increase(indent));
+
+        // 块集合中只占一行的节点之后换行
+        if (flow && frame.kind == Frame_Kind::BLOCK)
+            output_.write_new_line();
+
+        frame.key_done = false;
+        ++frame.iter;
     }
 
-    void Serializer::write_value(const Node &node, uint32_t indent)
+    void Serializer::write_json_scalar(const Node &node)
     {
-        fill_blank(indent);
-        write(": ");
-        if (column() > increase(indent) + 1 && !line_style(node)) {
-            write_new_line();
+        auto str = node.scalar_view();
+        auto &value = node.resolve();
+        char buffer[32];
+
+        switch (value.type) {
+        case Scalar_Type::BOOL:
+            output_.write_raw(value.boolean ? "true" : "false");
+            return;
+        case Scalar_Type::INT:
+            if (is_json_number(str)) {
+                output_.write_raw(str);
+            } else {
+                auto end = std::to_chars(
+                                   buffer, buffer + sizeof(buffer),
+                                   value.integer)
+                                   .ptr;
+                output_.write_raw(std::string_view(buffer, end - buffer));
+            }
+            return;
+        case Scalar_Type::FLOAT:
+            // JSON 没有无穷大和 NaN，按字符串输出
+            if (!std::isfinite(value.real))
+                break;
+
+            if (is_json_number(str)) {
+                output_.write_raw(str);
+            } else {
+                auto end = std::to_chars(
+                                   buffer, buffer + sizeof(buffer),
+                                   value.real)
+                                   .ptr;
+                output_.write_raw(std::string_view(buffer, end - buffer));
+            }
+            return;
+        default:
+            // 与空值混淆的标量节点在 YAML 中也加引号，保持为字符串
+            break;
         }
-        write_node(node, increase(indent));
-        if (line_style(node)) {
-            write_new_line();
+
+        write_double_quoted(output_, str, true, true);
+    }
+
+    void Serializer::write_json_key(const Node &node)
+    {
+        if (node.is_null()) {
+            output_.write_raw("\"null\"");
+        } else if (node.is_scalar()) {
+            write_double_quoted(output_, node.scalar_view(), true, true);
+        } else {
+            throw Representation_Exception(error_msgs::JSON_KEY, Mark());
         }
     }
 
@@ -0,0 +1,362 @@
+/**
+ * @file        snapshot.cpp
+ * @brief       节点树的二进制快照
+ * @details     主要包含 Snapshot_Writer、Snapshot_Reader 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/parser/snapshot.h"
+#include "cyaml/error/error_msgs.h"
+#include "cyaml/error/exceptions.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace cyaml
+{
+    static constexpr uint64_t PRIME1 = 0x9e3779b185ebca87ULL;
+    static constexpr uint64_t PRIME2 = 0xc2b2ae3d27d4eb4fULL;
+
+    /**
+     * @brief   混合一个 8 字节数据
+     * @param   acc     累加值
+     * @param   word    数据
+     * @return  uint64_t
+     */
+    static inline uint64_t mix(uint64_t acc, uint64_t word)
+    {
+        acc += word * PRIME2;
+        acc = (acc << 31) | (acc >> 33);
+        return acc * PRIME1;
+    }
+
+    uint64_t snapshot_checksum(const char *data, size_t size)
+    {
+        // 四路互不依赖，可以同时计算
+        uint64_t lanes[4] = {PRIME1, PRIME2, 0, PRIME1 + PRIME2};
+        size_t pos = 0;
+        for (; pos + 4 * sizeof(uint64_t) <= size;
+             pos += 4 * sizeof(uint64_t)) {
+            uint64_t words[4];
+            std::memcpy(words, data + pos, sizeof(words));
+            for (int i = 0; i < 4; i++)
+                lanes[i] = mix(lanes[i], words[i]);
+        }
+
+        // 剩余不足 8 字节的部分补 0
+        for (; pos < size; pos += sizeof(uint64_t)) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + pos, std::min(size - pos, sizeof(word)));
+            lanes[0] = mix(lanes[0], word);
+        }
+
+        uint64_t hash = size;
+        for (auto lane : lanes)
+            hash = mix(hash, lane);
+        return hash ^ (hash >> 29);
+    }
+
+    /**
+     * @struct  Frame
+     * @brief   正在写入的集合
+     */
+    struct Snapshot_Writer::Frame
+    {
+        Node::const_iterator iter; // 下一个条目
+        Node::const_iterator end;  // 最后一个条目之后
+        size_t slot;               // 下一个子节点偏移在输出中的位置
+        size_t index;              // 键索引在输出中的位置
+        uint32_t capacity;         // 键索引的槽数
+        uint32_t entry;            // 当前条目序号
+        bool map;                  // 是否为 map
+        bool key_done;             // map 当前条目的键是否已写入
+    };
+
+    void Snapshot_Writer::write(const Node &node)
+    {
+        size_t header = out_.size();
+        out_.resize(header + sizeof(Snapshot_Header));
+        body_ = out_.size();
+        write_tree(node);
+
+        Snapshot_Header head{};
+        std::memcpy(head.magic, SNAPSHOT_MAGIC, sizeof(head.magic));
+        head.version = SNAPSHOT_VERSION;
+        head.byte_order = SNAPSHOT_BYTE_ORDER;
+        head.size = out_.size() - body_;
+        head.checksum = snapshot_checksum(out_.data() + body_, head.size);
+        head.flags = node.is_frozen() ? SNAPSHOT_FROZEN : 0;
+        std::memcpy(&out_[header], &head, sizeof(head));
+    }
+
+    void Snapshot_Writer::write_tree(const Node &node)
+    {
+        std::vector<Frame> stack;
+        write_node(node, stack);
+
+        while (!stack.empty()) {
+            auto &frame = stack.back();
+            if (frame.iter == frame.end) {
+                stack.pop_back();
+                continue;
+            }
+
+            // 写入子节点可能使 frame 失效，先更新集合的状态
+            auto entry = *frame.iter;
+            const Node *child = &entry.second;
+            size_t slot = frame.slot;
+            frame.slot += sizeof(uint32_t);
+            if (frame.map && !frame.key_done) {
+                child = &entry.first;
+                if (frame.capacity > 0 && child->is_scalar()) {
+                    index_key(
+                            frame.index, frame.capacity, child->scalar_view(),
+                            frame.entry);
+                }
+                frame.key_done = true;
+            } else {
+                frame.key_done = false;
+                frame.entry++;
+                ++frame.iter;
+            }
+
+            uint32_t offset = write_node(*child, stack);
+            std::memcpy(&out_[slot], &offset, sizeof(offset));
+        }
+    }
+
+    uint32_t Snapshot_Writer::write_node(
+            const Node &node,
+            std::vector<Frame> &stack)
+    {
+        uint32_t offset = out_.size() - body_;
+        Snapshot_Record record{};
+        record.type = static_cast<uint8_t>(node.type());
+        record.style = static_cast<uint8_t>(node.style());
+
+        if (node.is_scalar()) {
+            auto str = node.scalar_view();
+            if (str.size() > std::numeric_limits<uint32_t>::max()) {
+                throw Representation_Exception(
+                        error_msgs::SNAPSHOT_TOO_LARGE, Mark());
+            }
+
+            record.size = str.size();
+            size_t pos = reserve(sizeof(record) + str.size());
+            std::memcpy(&out_[pos], &record, sizeof(record));
+            std::memcpy(&out_[pos + sizeof(record)], str.data(), str.size());
+            return offset;
+        }
+
+        if (node.is_collection() && stack.size() >= max_depth_)
+            throw Representation_Exception(error_msgs::TOO_DEEP, Mark());
+
+        // 先预留子节点偏移和索引，子节点写入后回填
+        record.size = node.is_collection() ? node.size() : 0;
+        size_t slots = node.is_map() ? 2 * record.size
+                                     : node.is_seq() ? record.size : 0;
+        uint32_t capacity =
+                node.is_map() ? snapshot_index_capacity(record.size) : 0;
+        size_t pos = reserve(
+                sizeof(record) + slots * sizeof(uint32_t) +
+                capacity * sizeof(Snapshot_Slot));
+        std::memcpy(&out_[pos], &record, sizeof(record));
+
+        if (record.size > 0) {
+            size_t slot = pos + sizeof(record);
+            stack.push_back(
+                    {node.begin(), node.end(), slot,
+                     slot + slots * sizeof(uint32_t), capacity, 0,
+                     node.is_map(), false});
+        }
+
+        return offset;
+    }
+
+    void Snapshot_Writer::index_key(
+            size_t index,
+            uint32_t capacity,
+            std::string_view key,
+            uint32_t entry)
+    {
+        Snapshot_Slot slot{snapshot_key_hash(key), entry + 1};
+        for (uint32_t i = slot.hash & (capacity - 1);;
+             i = (i + 1) & (capacity - 1)) {
+            char *pos = &out_[index + i * sizeof(Snapshot_Slot)];
+            Snapshot_Slot used;
+            std::memcpy(&used, pos, sizeof(used));
+            if (used.entry == 0) {
+                std::memcpy(pos, &slot, sizeof(slot));
+                return;
+            }
+        }
+    }
+
+    size_t Snapshot_Writer::reserve(size_t size)
+    {
+        size_t pos = out_.size();
+        size = (size + 3) & ~size_t(3);
+        if (pos - body_ + size > std::numeric_limits<uint32_t>::max()) {
+            throw Representation_Exception(
+                    error_msgs::SNAPSHOT_TOO_LARGE, Mark());
+        }
+
+        // 补齐的字节为 0，相同的节点树得到相同的快照
+        out_.resize(pos + size);
+        return pos;
+    }
+
+    Snapshot_Header read_snapshot_header(std::string_view data, bool verify)
+    {
+        Snapshot_Header head;
+        if (data.size() < sizeof(head))
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        std::memcpy(&head, data.data(), sizeof(head));
+        if (std::memcmp(head.magic, SNAPSHOT_MAGIC, sizeof(head.magic)) != 0)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        if (head.byte_order != SNAPSHOT_BYTE_ORDER ||
+            head.version != SNAPSHOT_VERSION) {
+            throw Parse_Exception(error_msgs::SNAPSHOT_VERSION, Mark());
+        }
+
+        if (head.size != data.size() - sizeof(head))
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        if (verify && snapshot_checksum(data.data() + sizeof(head),
+                                        head.size) != head.checksum) {
+            throw Parse_Exception(error_msgs::SNAPSHOT_CHECKSUM, Mark());
+        }
+
+        return head;
+    }
+
+    Snapshot_Reader::Snapshot_Reader(
+            std::string_view data,
+            std::pmr::memory_resource *resource)
+        : resource_(resource)
+    {
+        Snapshot_Header head = read_snapshot_header(data, true);
+        body_ = data.data() + sizeof(head);
+        size_ = head.size;
+        flags_ = head.flags;
+    }
+
+    Node Snapshot_Reader::root()
+    {
+        Node root = *build(0);
+        if (flags_ & SNAPSHOT_FROZEN)
+            root.freeze();
+        return root;
+    }
+
+    /**
+     * @struct  Frame
+     * @brief   正在构建的集合
+     */
+    struct Snapshot_Reader::Frame
+    {
+        Node_Data *data;  // 集合数据
+        Node_Ptr key;     // map 当前条目已构建的键
+        size_t pos;       // 下一个子节点偏移的位置
+        size_t remaining; // 剩余的子节点偏移个数
+        uint32_t offset;  // 集合记录的偏移
+        bool map;         // 是否为 map
+    };
+
+    Node_Ptr Snapshot_Reader::build(uint32_t offset)
+    {
+        std::vector<Frame> stack;
+        auto root = build_node(offset, stack);
+
+        while (!stack.empty()) {
+            auto &frame = stack.back();
+            if (frame.remaining == 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            uint32_t next = child(frame.pos, frame.offset);
+            frame.pos += sizeof(uint32_t);
+            frame.remaining--;
+
+            // 构建子节点可能使 frame 失效，之后按下标访问
+            size_t index = stack.size() - 1;
+            auto node = build_node(next, stack);
+            auto &parent = stack[index];
+            node->parent_ = parent.data;
+            if (!parent.map) {
+                parent.data->seq.emplace_back(std::move(node));
+            } else if (!parent.key) {
+                parent.key = std::move(node);
+            } else {
+                parent.data->map.emplace_back(
+                        std::move(parent.key), std::move(node));
+            }
+        }
+
+        return root;
+    }
+
+    Node_Ptr Snapshot_Reader::build_node(
+            uint32_t offset,
+            std::vector<Frame> &stack)
+    {
+        Snapshot_Record record;
+        check(offset, sizeof(record));
+        std::memcpy(&record, body_ + offset, sizeof(record));
+
+        auto type = static_cast<Node_Type>(record.type);
+        if (type != Node_Type::NONE && type != Node_Type::MAP &&
+            type != Node_Type::SEQ && type != Node_Type::SCALAR) {
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+        }
+        if (record.style > static_cast<uint8_t>(Node_Style::FLOW))
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+
+        auto node = make_pmr_shared<Node>(resource_, type, resource_);
+        node->style_ = static_cast<Node_Style>(record.style);
+
+        size_t pos = offset + sizeof(record);
+        auto &data = *node->data_;
+        if (type == Node_Type::SCALAR) {
+            check(pos, record.size);
+            data.scalar.assign(body_ + pos, record.size);
+            return node;
+        }
+        if (type == Node_Type::NONE)
+            return node;
+
+        if (stack.size() >= max_depth_)
+            throw Parse_Exception(error_msgs::TOO_DEEP, Mark());
+
+        bool map = type == Node_Type::MAP;
+        size_t slots = map ? 2 * size_t(record.size) : record.size;
+        check(pos, slots * sizeof(uint32_t));
+        if (map)
+            data.map.reserve(record.size);
+        else
+            data.seq.reserve(record.size);
+
+        if (slots > 0)
+            stack.push_back({&data, nullptr, pos, slots, offset, map});
+        return node;
+    }
+
+    uint32_t Snapshot_Reader::child(size_t pos, uint32_t parent) const
+    {
+        uint32_t offset;
+        std::memcpy(&offset, body_ + pos, sizeof(offset));
+        if (offset <= parent)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+        return offset;
+    }
+
+    void Snapshot_Reader::check(size_t offset, size_t size) const
+    {
+        if (offset > size_ || size > size_ - offset)
+            throw Parse_Exception(error_msgs::INVALID_SNAPSHOT, Mark());
+    }
+
+} // namespace cyaml
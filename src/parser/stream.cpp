@@ -50,6 +50,8 @@ namespace cyaml
 
     void Stream::check(char ch)
     {
+        mark_.offset++;
+
         switch (ch) {
         case '\n':
             mark_.line++;
@@ -7,44 +7,71 @@
 
 #include "cyaml/type/node/node.h"
 #include "cyaml/error/exceptions.h"
+#include "cyaml/parser/lazy_builder.h"
 #include <algorithm>
 #include <iostream>
+#include <utility>
 
 namespace cyaml
 {
-    Node::Node(Node_Type type)
-        : type_(type),
-          data_(std::make_shared<Node_Data>())
+    Node::Node(Node_Type type, std::pmr::memory_resource *resource)
+        : data_(make_pmr_shared<Node_Data>(resource, resource)),
+          type_(type)
     {
         data_->insert_ref(this);
     }
 
     Node::Node(const Node &node)
-        : type_(node.type_),
-          style_(node.style_),
-          data_(node.data_)
+        : data_(node.data_),
+          type_(node.type_),
+          style_(node.style_)
     {
         data_->insert_ref(this);
     }
 
+    Node::Node(Node &&node)
+        : data_(node.data_),
+          type_(node.type_),
+          style_(node.style_)
+    {
+        // 冻结的数据不能从节点树中移出，与复制相同
+        if (node.frozen_ || data_->frozen)
+            return;
+
+        // 原节点可能是节点树中的子节点，移动后成为新的空值
+        auto *resource = data_->resource();
+        node.type_ = Node_Type::NONE;
+        node.style_ = Node_Style::BLOCK;
+        node.data_ = make_pmr_shared<Node_Data>(resource, resource);
+        node.data_->insert_ref(&node);
+        Node_Data::invalidate_parents(node.parent_);
+
+        // 数据不再位于源数据中的位置
+        data_->untrack(&node);
+        data_->remove_ref(&node);
+        data_->insert_ref(this);
+    }
+
     Node::Node(const Node_Ptr &node)
-        : type_(node->type_),
-          style_(node->style_),
-          data_(node->data_)
+        : data_(node->data_),
+          type_(node->type_),
+          style_(node->style_)
     {
         data_->insert_ref(this);
     }
 
-    Node::Node(const std::string &scalar)
-        : type_(Node_Type::SCALAR),
-          style_(Node_Style::BLOCK),
-          data_(std::make_shared<Node_Data>(scalar))
+    Node::Node(const std::string &scalar, std::pmr::memory_resource *resource)
+        : data_(make_pmr_shared<Node_Data>(resource, scalar, resource)),
+          type_(Node_Type::SCALAR),
+          style_(Node_Style::BLOCK)
     {
         data_->insert_ref(this);
     }
 
     Node::~Node()
     {
+        // 地址可能被新节点复用，不能再用于判断数据的位置
+        data_->untrack(this);
         data_->remove_ref(this);
     }
 
@@ -56,19 +83,26 @@ namespace cyaml
         if (n1.type() != n2.type() || n1.size() != n2.size())
             return false;
 
-        if (n1.type() == n2.type() && n1.data_ == n2.data_)
+        if (n1.type() == n2.type() && &n1.body() == &n2.body())
             return true;
 
+        // 只有两边哈希都已缓存时才先比较哈希，比较运算不写入缓存，
+        // 未冻结的节点树可以被多个线程同时比较
+        auto &b1 = n1.body();
+        auto &b2 = n2.body();
+        if (b1.hash_cached() && b2.hash_cached() && b1.hash != b2.hash)
+            return false;
+
         if (n1.is_scalar() && n2.is_scalar())
-            return (n1.scalar() == n2.scalar());
+            return (b1.scalar == b2.scalar);
 
         if (n1.is_map() && n2.is_map()) {
             if (n1.size() != n2.size())
                 return false;
 
-            auto it1 = n1.data_->map.begin();
-            auto it2 = n2.data_->map.begin();
-            while (it1 != n1.data_->map.end()) {
+            auto it1 = n1.body().map.begin();
+            auto it2 = n2.body().map.begin();
+            while (it1 != n1.body().map.end()) {
                 if (it1->first != it2->first || it1->second != it2->second)
                     return false;
 
@@ -84,7 +118,7 @@ namespace cyaml
                 return false;
 
             for (int i = 0; i < n1.size(); i++) {
-                if (n1.data_->seq[i] != n2.data_->seq[i])
+                if (n1.body().seq[i] != n2.body().seq[i])
                     return false;
             }
 
@@ -115,21 +149,56 @@ namespace cyaml
         case Node_Type::NONE:
             return 0;
         case Node_Type::MAP:
-            return data_->map.size();
+            return body().map.size();
         case Node_Type::SEQ:
-            return data_->seq.size();
+            return body().seq.size();
         case Node_Type::SCALAR:
-            return data_->scalar.size();
+            return body().scalar.size();
         }
 
         return 0;
     }
 
+    size_t Node::hash() const
+    {
+        if (is_null())
+            return 0;
+
+        auto &body = this->body();
+        if (body.hash_cached())
+            return body.hash;
+
+        // 锚点形成的环，正在计算的节点只计入类型
+        if (body.hash_state == Hash_State::HASHING)
+            return static_cast<size_t>(type_);
+
+        body.hash_state = Hash_State::HASHING;
+
+        size_t seed = static_cast<size_t>(type_);
+        if (is_scalar()) {
+            hash_combine(seed, std::hash<std::string_view>()(body.scalar));
+        } else if (is_map()) {
+            for (auto &[key, value] : body.map) {
+                hash_combine(seed, key->hash());
+                hash_combine(seed, value->hash());
+            }
+        } else if (is_seq()) {
+            for (auto &i : body.seq) {
+                hash_combine(seed, i->hash());
+            }
+        }
+
+        body.hash = seed;
+        body.hash_state = Hash_State::VALID;
+        return seed;
+    }
+
     std::vector<Node> Node::keys() const
     {
         std::vector<Node> ret;
+        auto &map = body().map;
         std::transform(
-                data_->map.begin(), data_->map.end(), std::back_inserter(ret),
+                map.begin(), map.end(), std::back_inserter(ret),
                 [](KV_Pair &i) {
                     return *(i.first);
                 });
@@ -137,6 +206,42 @@ namespace cyaml
         return ret;
     }
 
+    Node::iterator Node::begin()
+    {
+        detach();
+        auto it = std::as_const(*this).begin();
+        return it.pair() ? iterator(it.pair()) : iterator(it.elem());
+    }
+
+    Node::const_iterator Node::begin() const
+    {
+        auto &body = this->body();
+        if (is_map())
+            return const_iterator(body.map.data());
+        if (is_seq())
+            return const_iterator(body.seq.data());
+
+        return const_iterator();
+    }
+
+    Node::iterator Node::end()
+    {
+        detach();
+        auto it = std::as_const(*this).end();
+        return it.pair() ? iterator(it.pair()) : iterator(it.elem());
+    }
+
+    Node::const_iterator Node::end() const
+    {
+        auto &body = this->body();
+        if (is_map())
+            return const_iterator(body.map.data() + body.map.size());
+        if (is_seq())
+            return const_iterator(body.seq.data() + body.seq.size());
+
+        return const_iterator();
+    }
+
     Node &Node::operator[](uint32_t index)
     {
         if (is_null()) {
@@ -146,6 +251,9 @@ namespace cyaml
         if (!is_seq())
             throw Dereference_Exception();
 
+        // 返回的子节点可能被修改，需要先复制共享数据
+        detach();
+
         ///< @todo  out_of_range exception
         if (index >= data_->seq.size())
             throw Dereference_Exception();
@@ -155,11 +263,11 @@ namespace cyaml
 
     const Node &Node::operator[](uint32_t index) const
     {
-        if (!is_seq() || index >= data_->seq.size()) {
+        if (!is_seq() || index >= body().seq.size()) {
             throw Dereference_Exception();
         }
 
-        return *(data_->seq[index]);
+        return *(body().seq[index]);
     }
 
     Node &Node::operator[](const std::string &key)
@@ -181,10 +289,14 @@ namespace cyaml
         if (!is_map())
             throw Dereference_Exception();
 
-        auto key_node = std::make_shared<Node>(key);
-        auto iter = find(key_node);
+        detach();
+
+        auto iter = find(key);
         if (iter == data_->map.end()) {
-            auto value_node = std::make_shared<Node>();
+            check_mutable();
+            auto key_node = make_pmr_shared<Node>(resource(), key);
+            auto value_node = make_pmr_shared<Node>(
+                    resource(), Node_Type::NONE, resource());
             insert(key_node, value_node);
             return *value_node;
         }
@@ -194,16 +306,34 @@ namespace cyaml
 
     const Node &Node::operator[](const Node &key) const
     {
-        if (!is_map() || !contain(key)) {
+        if (!is_map()) {
             throw Dereference_Exception();
         }
 
-        auto key_node = std::make_shared<Node>(key);
-        return *(find(key_node)->second);
+        auto iter = find(key);
+        if (iter == body().map.end()) {
+            throw Dereference_Exception();
+        }
+
+        return *(iter->second);
     }
 
     Node &Node::operator=(const Node &rhs)
     {
+        if (frozen_)
+            throw Frozen_Exception();
+
+        // 冻结数据没有引用表，只重新绑定当前节点
+        if (data_->frozen) {
+            Node_Data::invalidate_parents(parent_);
+            type_ = rhs.type_;
+            style_ = rhs.style_;
+            data_ = rhs.data_;
+            data_->insert_ref(this);
+            return *this;
+        }
+
+        data_->invalidate_hash();
         auto refs = data_->refs;
         for (auto *i : refs) {
             i->type_ = rhs.type_;
@@ -221,8 +351,7 @@ namespace cyaml
         if (!is_map())
             return false;
 
-        auto key_node = std::make_shared<Node>(key);
-        return (find(key_node) != data_->map.end());
+        return (find(Node(key)) != body().map.end());
     }
 
     bool Node::contain(const Node &key) const
@@ -230,15 +359,15 @@ namespace cyaml
         if (!is_map())
             return false;
 
-        auto key_node = std::make_shared<Node>(key);
-        return find(key_node) != data_->map.end();
+        return find(key) != body().map.end();
     }
 
-    Map::iterator Node::find(const Node_Ptr &key) const
+    Map::iterator Node::find(const Node &key) const
     {
+        auto &map = body().map;
         auto iter = std::find_if(
-                data_->map.begin(), data_->map.end(), [&](const KV_Pair &p) {
-                    return p.first == key;
+                map.begin(), map.end(), [&](const KV_Pair &p) {
+                    return *p.first == key;
                 });
         return iter;
     }
@@ -252,9 +381,29 @@ namespace cyaml
         if (!is_map())
             return false;
 
+        check_mutable();
+
         // 插入节点
-        auto key_node = std::make_shared<Node>(key);
-        auto value_node = std::make_shared<Node>(value);
+        auto key_node = make_pmr_shared<Node>(resource(), key);
+        auto value_node = make_pmr_shared<Node>(resource(), value);
+        insert(key_node, value_node);
+
+        return true;
+    }
+
+    bool Node::insert(Node &&key, Node &&value)
+    {
+        if (is_null()) {
+            reset(Node_Type::MAP);
+        }
+
+        if (!is_map())
+            return false;
+
+        check_mutable();
+
+        auto key_node = make_pmr_shared<Node>(resource(), std::move(key));
+        auto value_node = make_pmr_shared<Node>(resource(), std::move(value));
         insert(key_node, value_node);
 
         return true;
@@ -269,18 +418,66 @@ namespace cyaml
         if (!is_seq())
             return false;
 
-        data_->seq.emplace_back(std::make_shared<Node>(node));
+        check_mutable();
+        append(make_pmr_shared<Node>(resource(), node));
+
+        return true;
+    }
+
+    bool Node::push_back(Node &&node)
+    {
+        if (is_null()) {
+            reset(Node_Type::SEQ);
+        }
+
+        if (!is_seq())
+            return false;
+
+        check_mutable();
+        append(make_pmr_shared<Node>(resource(), std::move(node)));
+
+        return true;
+    }
+
+    bool Node::insert(uint32_t index, const Node &node)
+    {
+        if (is_null() && index == 0) {
+            reset(Node_Type::SEQ);
+        }
+
+        if (!is_seq() || index > size())
+            return false;
+
+        check_mutable();
+        auto child = make_pmr_shared<Node>(resource(), node);
+        child->parent_ = data_.get();
+        data_->seq.emplace(data_->seq.begin() + index, child);
+        data_->invalidate_hash();
 
         return true;
     }
 
+    void Node::reserve(uint32_t size)
+    {
+        check_mutable();
+
+        if (is_map()) {
+            data_->map.reserve(size);
+        } else if (is_seq()) {
+            data_->seq.reserve(size);
+        }
+    }
+
     bool Node::erase(const Node &key)
     {
         if (!is_map())
             return false;
 
-        auto key_node = std::make_shared<Node>(key);
-        if (auto iter = find(key_node); iter != data_->map.end()) {
+        if (auto iter = find(key); iter != data_->map.end()) {
+            check_mutable();
+            if (iter->first->parent_ == data_.get())
+                iter->first->parent_ = nullptr;
+            iter->second->parent_ = nullptr;
             data_->map.erase(iter);
             return true;
         }
@@ -288,35 +485,136 @@ namespace cyaml
         return false;
     }
 
-    void Node::clone(Node_Ptr &node) const
+    bool Node::erase(uint32_t index)
     {
-        node = std::make_shared<Node>(type());
+        if (!is_seq() || index >= size())
+            return false;
+
+        check_mutable();
+        data_->seq[index]->parent_ = nullptr;
+        data_->seq.erase(data_->seq.begin() + index);
+
+        return true;
+    }
+
+    void Node::freeze()
+    {
+        // 已冻结的数据无需重复处理，同时避免锚点形成的环导致无限递归
+        if (data_->frozen)
+            return;
+
+        if (data_->is_lazy())
+            materialize();
+
+        // 冻结后不能再延迟写入缓存，需要提前解析
+        if (is_scalar()) {
+            body().resolve();
+        }
+
+        data_->frozen = true;
+        data_->refs.clear();
+
+        for (auto &[key, value] : data_->map) {
+            key->frozen_ = true;
+            value->frozen_ = true;
+            key->freeze();
+            value->freeze();
+        }
+
+        for (auto &i : data_->seq) {
+            i->frozen_ = true;
+            i->freeze();
+        }
+
+        hash();
+    }
+
+    void Node::clone(Node_Ptr &node, std::pmr::memory_resource *resource)
+            const
+    {
+        if (data_->is_lazy())
+            materialize();
+
+        node = make_pmr_shared<Node>(resource, type(), resource);
+        node->style_ = style_;
+
+        // 冻结的数据不会再被修改，克隆节点直接共享，修改时再复制
+        if (data_->frozen || data_->source) {
+            node->data_->source = data_->source ? data_->source : data_;
+            return;
+        }
 
         if (is_scalar()) {
             node->data_->scalar = data_->scalar;
+            node->data_->value = data_->value;
         }
 
         if (is_map()) {
+            node->data_->map.reserve(data_->map.size());
             for (auto &[key, value] : data_->map) {
                 Node_Ptr key_node;
                 Node_Ptr value_node;
-                key->clone(key_node);
-                key->clone(value_node);
+                key->clone(key_node, resource);
+                value->clone(value_node, resource);
                 node->insert(key_node, value_node);
             }
         }
 
         if (is_seq()) {
+            node->data_->seq.reserve(data_->seq.size());
             for (auto &i : data_->seq) {
                 Node_Ptr next_node;
-                i->clone(next_node);
-                node->data_->seq.emplace_back(next_node);
+                i->clone(next_node, resource);
+                node->append(next_node);
             }
         }
     }
 
+    void Node::detach()
+    {
+        if (data_->is_lazy())
+            materialize();
+
+        if (!data_->source || data_->frozen)
+            return;
+
+        auto source = std::move(data_->source);
+        data_->source = nullptr;
+
+        data_->scalar = source->scalar;
+        data_->value = source->value;
+
+        // 内容不变，沿用哈希缓存，上层集合的缓存有效时当前层也必须有效
+        data_->hash = source->hash;
+        data_->hash_state = source->hash_state;
+
+        // 键节点已冻结，可以直接共享；值节点替换为新的克隆节点
+        auto *resource = data_->resource();
+        data_->map.reserve(source->map.size());
+        for (auto &[key, value] : source->map) {
+            Node_Ptr value_node;
+            value->clone(value_node, resource);
+            value_node->parent_ = data_.get();
+            data_->map.emplace_back(key, value_node);
+        }
+
+        data_->seq.reserve(source->seq.size());
+        for (auto &i : source->seq) {
+            Node_Ptr next_node;
+            i->clone(next_node, resource);
+            next_node->parent_ = data_.get();
+            data_->seq.emplace_back(next_node);
+        }
+    }
+
+    void Node::materialize() const
+    {
+        Lazy_Builder::materialize(*this);
+    }
+
     void Node::assign(Node_Data_Ptr data)
     {
+        data_->invalidate_hash();
         for (auto *node : data_->refs) {
             node->data_ = data;
             data->insert_ref(node);
@@ -7,13 +7,373 @@
 
 #include "cyaml/type/node/node_data.h"
 #include "cyaml/type/node/node.h"
+#include <charconv>
+#include <limits>
+#include <new>
 
 namespace cyaml
 {
-    Node_Data::Node_Data(std::string value): scalar(value) {}
+    Node_Data::Node_Data(std::pmr::memory_resource *resource)
+        : map(resource),
+          seq(resource),
+          scalar(resource),
+          refs(resource)
+    {
+    }
+
+    Node_Data::Node_Data(
+            const std::string &value,
+            std::pmr::memory_resource *resource)
+        : map(resource),
+          seq(resource),
+          scalar(value.data(), value.size(), resource),
+          refs(resource)
+    {
+    }
+
+    bool Node_Data::owns_children(const Node_Ptr &node)
+    {
+        if (!node || node.use_count() != 1 || node->data_.use_count() != 1)
+            return false;
+
+        auto &data = *node->data_;
+        return !data.map.empty() || !data.seq.empty();
+    }
+
+    Node_Data::~Node_Data()
+    {
+        if (tracked) {
+            std::pmr::polymorphic_allocator<Source_State> alloc(resource());
+            tracked->~Source_State();
+            alloc.deallocate(tracked, 1);
+        }
+
+        orphan_children();
+
+        bool nested = false;
+        for (auto &[key, value] : map) {
+            nested = nested || owns_children(key) || owns_children(value);
+        }
+        for (auto &i : seq) {
+            nested = nested || owns_children(i);
+        }
+        if (!nested)
+            return;
+
+        // 深层嵌套的节点树逐层递归释放会耗尽调用栈，
+        // 先取出只被当前集合持有的子孙节点，再逐个释放
+        std::vector<Node_Ptr> pending;
+        auto take = [&pending](Node_Data &data) {
+            data.orphan_children();
+            for (auto &[key, value] : data.map) {
+                pending.push_back(std::move(key));
+                pending.push_back(std::move(value));
+            }
+            for (auto &i : data.seq) {
+                pending.push_back(std::move(i));
+            }
+            data.map.clear();
+            data.seq.clear();
+        };
+
+        take(*this);
+        while (!pending.empty()) {
+            Node_Ptr node = std::move(pending.back());
+            pending.pop_back();
+            if (owns_children(node))
+                take(*node->data_);
+        }
+    }
+
+    Source_State &Node_Data::track()
+    {
+        if (!tracked) {
+            std::pmr::polymorphic_allocator<Source_State> alloc(resource());
+            tracked = new (alloc.allocate(1)) Source_State();
+        }
+
+        return *tracked;
+    }
+
+    void Node_Data::orphan_children() noexcept
+    {
+        // 子节点可能被其它指针持有，不能再指向已移除它的集合
+        for (auto &[key, value] : map) {
+            if (key->parent_ == this)
+                key->parent_ = nullptr;
+            if (value->parent_ == this)
+                value->parent_ = nullptr;
+        }
+
+        for (auto &i : seq) {
+            if (i->parent_ == this)
+                i->parent_ = nullptr;
+        }
+    }
+
+    void Node_Data::invalidate_hash() noexcept
+    {
+        hash_state = Hash_State::STALE;
+        for (auto *node : refs) {
+            invalidate_parents(node->parent_);
+        }
+    }
+
+    void Node_Data::invalidate_parents(Node_Data *data) noexcept
+    {
+        // 通常只有一个节点引用集合数据，沿单链循环，其余分支递归处理
+        while (data && data->hash_state == Hash_State::VALID) {
+            data->hash_state = Hash_State::STALE;
+
+            Node_Data *next = nullptr;
+            for (auto *node : data->refs) {
+                if (!node->parent_)
+                    continue;
+
+                if (next)
+                    invalidate_parents(node->parent_);
+                else
+                    next = node->parent_;
+            }
+            data = next;
+        }
+    }
+
+    /**
+     * @brief   判断是否为十进制数字
+     * @param   c   字符
+     * @return  bool
+     */
+    static bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * @brief   判断字符串是否全部由指定进制的数字组成
+     * @param   first   起始位置
+     * @param   last    结束位置
+     * @param   base    进制
+     * @return  bool
+     */
+    static bool all_digits(const char *first, const char *last, int base)
+    {
+        if (first == last)
+            return false;
+
+        for (auto *p = first; p != last; p++) {
+            char c = *p;
+            bool digit = false;
+            if (base == 16) {
+                digit = is_digit(c) || (c >= 'a' && c <= 'f') ||
+                        (c >= 'A' && c <= 'F');
+            } else {
+                digit = c >= '0' && c < '0' + base;
+            }
+
+            if (!digit)
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief   按 core schema 解析整数
+     * @details [-+]?[0-9]+ | 0o[0-7]+ | 0x[0-9a-fA-F]+
+     * @param   str     标量
+     * @param   value   解析结果
+     * @return  bool
+     */
+    static bool resolve_int(std::string_view str, Scalar_Value &value)
+    {
+        const char *first = str.data();
+        const char *last = first + str.size();
+        int base = 10;
+        bool negative = false;
+
+        if (str.size() > 2 && str[0] == '0' &&
+            (str[1] == 'o' || str[1] == 'x')) {
+            base = str[1] == 'o' ? 8 : 16;
+            first += 2;
+        } else if (first != last && (*first == '-' || *first == '+')) {
+            negative = *first == '-';
+            first++;
+        }
+
+        if (!all_digits(first, last, base))
+            return false;
+
+        uint64_t magnitude = 0;
+        auto [ptr, ec] = std::from_chars(first, last, magnitude, base);
+        uint64_t limit = static_cast<uint64_t>(
+                                 std::numeric_limits<int64_t>::max()) +
+                         (negative ? 1 : 0);
+        if (ec != std::errc() || ptr != last || magnitude > limit) {
+            // 十进制超出 int64 范围时按浮点数处理，八进制和十六进制按字符串处理
+            return false;
+        }
+
+        value.type = Scalar_Type::INT;
+        value.integer = negative ? static_cast<int64_t>(0 - magnitude)
+                                 : static_cast<int64_t>(magnitude);
+        return true;
+    }
+
+    /**
+     * @brief   判断超出 double 范围的浮点数是否为上溢
+     * @details 由第一个非零数字的位置和指数计算十进制数量级，
+     *          数量级为正时上溢，否则下溢
+     * @param   str     已检查格式的浮点数，不含符号
+     * @return  bool
+     */
+    static bool overflows(std::string_view str)
+    {
+        int64_t magnitude = 0;
+        bool found = false;
+        bool fraction = false;
+        size_t i = 0;
+        for (; i < str.size() && str[i] != 'e' && str[i] != 'E'; i++) {
+            if (str[i] == '.') {
+                fraction = true;
+            } else if (fraction) {
+                if (found)
+                    continue;
+                magnitude--;
+                found = str[i] != '0';
+            } else if (found || str[i] != '0') {
+                magnitude += found ? 1 : 0;
+                found = true;
+            }
+        }
+
+        // 指数足够大时已能确定结果，避免溢出
+        int64_t exponent = 0;
+        bool negative = false;
+        if (i < str.size()) {
+            i++;
+            if (str[i] == '-' || str[i] == '+')
+                negative = str[i++] == '-';
+            for (; i < str.size() && exponent < 1000000; i++) {
+                exponent = exponent * 10 + (str[i] - '0');
+            }
+        }
+
+        return magnitude + (negative ? -exponent : exponent) > 0;
+    }
+
+    /**
+     * @brief   按 core schema 解析浮点数
+     * @details [-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?
+     *          | [-+]?\.(inf|Inf|INF) | \.(nan|NaN|NAN)
+     * @param   str     标量
+     * @param   value   解析结果
+     * @return  bool
+     */
+    static bool resolve_float(std::string_view str, Scalar_Value &value)
+    {
+        if (str == ".nan" || str == ".NaN" || str == ".NAN") {
+            value.type = Scalar_Type::FLOAT;
+            value.real = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+
+        bool negative = false;
+        if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+            negative = str[0] == '-';
+            str.remove_prefix(1);
+        }
+
+        if (str == ".inf" || str == ".Inf" || str == ".INF") {
+            value.type = Scalar_Type::FLOAT;
+            value.real = negative ? -std::numeric_limits<double>::infinity()
+                                  : std::numeric_limits<double>::infinity();
+            return true;
+        }
+
+        // 检查格式，from_chars 接受的格式比 core schema 更宽松
+        size_t i = 0;
+        size_t int_digits = 0;
+        size_t frac_digits = 0;
+        while (i < str.size() && is_digit(str[i])) {
+            i++;
+            int_digits++;
+        }
+        if (i < str.size() && str[i] == '.') {
+            i++;
+            while (i < str.size() && is_digit(str[i])) {
+                i++;
+                frac_digits++;
+            }
+        }
+        if (int_digits == 0 && frac_digits == 0)
+            return false;
+
+        if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+            i++;
+            if (i < str.size() && (str[i] == '-' || str[i] == '+'))
+                i++;
+            if (i == str.size())
+                return false;
+            while (i < str.size() && is_digit(str[i])) {
+                i++;
+            }
+        }
+        if (i != str.size())
+            return false;
+
+        double real = 0;
+        auto [ptr, ec] = std::from_chars(
+                str.data(), str.data() + str.size(), real);
+        if (ptr != str.data() + str.size())
+            return false;
+
+        // 超出范围时 from_chars 不写入结果，上溢为无穷大，下溢为 0
+        if (ec == std::errc::result_out_of_range) {
+            real = overflows(str) ? std::numeric_limits<double>::infinity()
+                                  : 0.0;
+        } else if (ec != std::errc()) {
+            return false;
+        }
+
+        value.type = Scalar_Type::FLOAT;
+        value.real = negative ? -real : real;
+        return true;
+    }
+
+    Scalar_Value resolve_scalar(std::string_view str)
+    {
+        Scalar_Value value;
+        if (str.empty() || str == "~" || str == "null" || str == "Null" ||
+            str == "NULL") {
+            value.type = Scalar_Type::NONE;
+        } else if (str == "true" || str == "True" || str == "TRUE") {
+            value.type = Scalar_Type::BOOL;
+            value.boolean = true;
+        } else if (str == "false" || str == "False" || str == "FALSE") {
+            value.type = Scalar_Type::BOOL;
+            value.boolean = false;
+        } else if (!resolve_int(str, value) && !resolve_float(str, value)) {
+            value.type = Scalar_Type::STRING;
+        }
+
+        return value;
+    }
+
+    const Scalar_Value &Node_Data::resolve()
+    {
+        if (value.type == Scalar_Type::UNRESOLVED)
+            value = resolve_scalar(std::string_view(scalar));
+
+        return value;
+    }
 
     void Node_Data::insert_ref(const Node *node)
     {
+        // 冻结数据会被多线程共享读取，不能修改引用表
+        if (frozen)
+            return;
+
         Node *n = const_cast<Node *>(node);
         if (refs.find(n) == refs.end()) {
             refs.insert(n);
@@ -22,6 +382,9 @@ namespace cyaml
 
     void Node_Data::remove_ref(const Node *node)
     {
+        if (frozen)
+            return;
+
         Node *n = const_cast<Node *>(node);
         if (refs.find(n) != refs.end()) {
             refs.erase(n);
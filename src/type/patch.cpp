@@ -0,0 +1,238 @@
+/**
+ * @file        patch.cpp
+ * @brief       节点树差异比较与补丁
+ * @details     主要包含 diff 和 apply_patch 函数实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/type/node/patch.h"
+#include "cyaml/error/exceptions.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cyaml
+{
+    /**
+     * @struct  Key_Hash
+     * @brief   查找 map 键使用的哈希
+     * @details 不调用 Node::hash()，比较过程不写入未冻结节点的哈希缓存；
+     *          集合作为键很少见，只按类型和大小计算
+     */
+    struct Key_Hash
+    {
+        size_t operator()(const Node &key) const
+        {
+            if (key.is_scalar())
+                return std::hash<std::string_view>()(key.scalar_view());
+
+            return static_cast<size_t>(key.type()) * 31 + key.size();
+        }
+    };
+
+    using Key_Index = std::unordered_map<
+            std::reference_wrapper<const Node>,
+            const Node *,
+            Key_Hash,
+            std::equal_to<Node>>;
+
+    /**
+     * @brief   记录一条修改
+     * @param   patch   补丁
+     * @param   op      操作类型
+     * @param   path    目标路径
+     * @param   value   新值
+     * @return  void
+     */
+    static void record(
+            Patch &patch,
+            Patch_Op op,
+            const std::vector<Node> &path,
+            const Node &value = Node())
+    {
+        patch.push_back({op, path, value.clone()});
+    }
+
+    /**
+     * @brief   递归比较节点
+     * @param   old_node    原节点
+     * @param   new_node    新节点
+     * @param   path        当前路径
+     * @param   patch       补丁
+     * @return  void
+     */
+    static void diff(
+            const Node &old_node,
+            const Node &new_node,
+            std::vector<Node> &path,
+            Patch &patch)
+    {
+        if (old_node.type() != new_node.type() ||
+            (old_node.is_scalar() && old_node != new_node)) {
+            record(patch, Patch_Op::REPLACE, path, new_node);
+            return;
+        }
+
+        // 冻结的节点哈希已缓存，相同数据和哈希不同的情况都在比较运算中
+        // 直接返回；未冻结时直接递归，相同的子树不会产生修改
+        if (!old_node.is_collection() ||
+            (old_node.is_frozen() && new_node.is_frozen() &&
+             old_node == new_node)) {
+            return;
+        }
+
+        if (old_node.is_map()) {
+            Key_Index index;
+            index.reserve(new_node.size());
+            for (auto [key, value] : new_node) {
+                index.emplace(key, &value);
+            }
+
+            for (auto [key, value] : old_node) {
+                path.push_back(key.clone());
+                auto iter = index.find(key);
+                if (iter == index.end()) {
+                    record(patch, Patch_Op::REMOVE, path);
+                } else {
+                    diff(value, *iter->second, path, patch);
+                    index.erase(iter);
+                }
+                path.pop_back();
+            }
+
+            // 剩余的键按新节点中的顺序添加
+            for (auto [key, value] : new_node) {
+                if (index.find(key) == index.end())
+                    continue;
+
+                path.push_back(key.clone());
+                record(patch, Patch_Op::ADD, path, value);
+                path.pop_back();
+            }
+        } else if (old_node.is_seq()) {
+            // 跳过相同的开头和结尾，只比较中间不同的部分
+            uint32_t old_size = old_node.size();
+            uint32_t new_size = new_node.size();
+            uint32_t prefix = 0;
+            while (prefix < old_size && prefix < new_size &&
+                   old_node[prefix] == new_node[prefix]) {
+                prefix++;
+            }
+
+            uint32_t suffix = 0;
+            while (suffix < old_size - prefix && suffix < new_size - prefix &&
+                   old_node[old_size - suffix - 1] ==
+                           new_node[new_size - suffix - 1]) {
+                suffix++;
+            }
+
+            uint32_t old_end = old_size - suffix;
+            uint32_t new_end = new_size - suffix;
+            uint32_t i = prefix;
+            for (; i < old_end && i < new_end; i++) {
+                path.emplace_back(std::to_string(i));
+                diff(old_node[i], new_node[i], path, patch);
+                path.pop_back();
+            }
+
+            // 多出的元素依次插入到相同结尾之前
+            for (; i < new_end; i++) {
+                path.emplace_back(std::to_string(i));
+                record(patch, Patch_Op::ADD, path, new_node[i]);
+                path.pop_back();
+            }
+
+            // 从后向前删除，保证应用补丁时下标有效
+            for (uint32_t j = old_end; j > i; j--) {
+                path.emplace_back(std::to_string(j - 1));
+                record(patch, Patch_Op::REMOVE, path);
+                path.pop_back();
+            }
+        }
+    }
+
+    Patch diff(const Node &old_node, const Node &new_node)
+    {
+        Patch patch;
+        std::vector<Node> path;
+        diff(old_node, new_node, path, patch);
+        return patch;
+    }
+
+    /**
+     * @brief   将路径项转换为数组下标
+     * @param   key     路径项
+     * @return  uint32_t
+     */
+    static uint32_t to_index(const Node &key)
+    {
+        if (!key.is_scalar())
+            throw Dereference_Exception();
+
+        auto &value = key.resolve();
+        if (value.type != Scalar_Type::INT || value.integer < 0)
+            throw Dereference_Exception();
+
+        return static_cast<uint32_t>(value.integer);
+    }
+
+    /**
+     * @brief   查找已存在的子节点
+     * @param   parent  父节点
+     * @param   key     路径项
+     * @return  Node &
+     */
+    static Node &child(Node &parent, const Node &key)
+    {
+        if (parent.is_seq())
+            return parent[to_index(key)];
+
+        if (!parent.contain(key))
+            throw Dereference_Exception();
+
+        return parent[key];
+    }
+
+    void apply_patch(Node &node, const Patch &patch)
+    {
+        for (auto &entry : patch) {
+            auto &path = entry.path;
+            if (path.empty()) {
+                if (entry.op != Patch_Op::REPLACE)
+                    throw Dereference_Exception();
+
+                node = entry.value.clone();
+                continue;
+            }
+
+            Node *parent = &node;
+            for (size_t i = 0; i + 1 < path.size(); i++) {
+                parent = &child(*parent, path[i]);
+            }
+
+            auto &key = path.back();
+            switch (entry.op) {
+            case Patch_Op::ADD:
+                if (parent->is_seq()) {
+                    if (!parent->insert(to_index(key), entry.value.clone()))
+                        throw Dereference_Exception();
+                } else if (parent->contain(key) ||
+                           !parent->insert(key.clone(), entry.value.clone())) {
+                    throw Dereference_Exception();
+                }
+                break;
+            case Patch_Op::REMOVE:
+                if (parent->is_seq() ? !parent->erase(to_index(key))
+                                     : !parent->erase(key)) {
+                    throw Dereference_Exception();
+                }
+                break;
+            case Patch_Op::REPLACE:
+                child(*parent, key) = entry.value.clone();
+                break;
+            }
+        }
+    }
+
+} // namespace cyaml
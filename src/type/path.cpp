@@ -0,0 +1,253 @@
+/**
+ * @file        path.cpp
+ * @brief       节点路径查询
+ * @details     主要包含 Path 类实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/type/node/path.h"
+#include "cyaml/error/exceptions.h"
+
+namespace cyaml
+{
+    /**
+     * @brief   解析下标
+     * @details 只接受不含前导 0 的十进制非负整数
+     * @param   key     键
+     * @return  int64_t
+     * @retval  -1:     不是下标
+     */
+    static int64_t parse_index(const std::string &key)
+    {
+        // 超过 10 位的数字超出 uint32_t 范围，不可能是有效下标
+        if (key.empty() || key.size() > 10)
+            return -1;
+
+        if (key[0] == '0' && key.size() > 1)
+            return -1;
+
+        int64_t index = 0;
+        for (char c : key) {
+            if (c < '0' || c > '9')
+                return -1;
+
+            index = index * 10 + (c - '0');
+        }
+
+        return index;
+    }
+
+    Path::Path(std::string_view expr)
+    {
+        if (expr.empty())
+            return;
+
+        if (expr[0] != '/')
+            throw Parse_Exception(error_msgs::INVALID_PATH, Mark(1, 1));
+
+        size_t begin = 1;
+        while (true) {
+            size_t end = expr.find('/', begin);
+            if (end == std::string_view::npos)
+                end = expr.size();
+
+            auto raw = expr.substr(begin, end - begin);
+            if (raw == "*") {
+                segments_.push_back({Path_Segment_Type::ANY, ""});
+            } else if (raw == "**") {
+                // 连续的 ** 与单个 ** 等价
+                if (segments_.empty() ||
+                    segments_.back().type != Path_Segment_Type::RECURSIVE) {
+                    segments_.push_back({Path_Segment_Type::RECURSIVE, ""});
+                }
+            } else {
+                std::string key;
+                for (size_t i = 0; i < raw.size(); i++) {
+                    if (raw[i] != '~') {
+                        key += raw[i];
+                    } else if (i + 1 < raw.size() && raw[i + 1] == '0') {
+                        key += '~';
+                        i++;
+                    } else if (i + 1 < raw.size() && raw[i + 1] == '1') {
+                        key += '/';
+                        i++;
+                    } else {
+                        throw Parse_Exception(
+                                error_msgs::INVALID_PATH,
+                                Mark(1, begin + i + 1));
+                    }
+                }
+
+                int64_t index = parse_index(key);
+                segments_.push_back(
+                        {Path_Segment_Type::KEY, std::move(key), index});
+            }
+
+            if (end == expr.size())
+                break;
+
+            begin = end + 1;
+        }
+    }
+
+    const Node *Path::find(const Node &root) const
+    {
+        std::vector<const Node *> result;
+        select(root, 0, result, true);
+        return result.empty() ? nullptr : result.front();
+    }
+
+    std::vector<const Node *> Path::select(const Node &root) const
+    {
+        std::vector<const Node *> result;
+        select(root, 0, result, false);
+        return result;
+    }
+
+    bool Path::select(
+            const Node &node,
+            size_t pos,
+            std::vector<const Node *> &result,
+            bool first_only) const
+    {
+        if (pos == segments_.size()) {
+            result.push_back(&node);
+            return first_only;
+        }
+
+        auto &segment = segments_[pos];
+        switch (segment.type) {
+        case Path_Segment_Type::KEY:
+            if (node.is_map()) {
+                // 直接比较标量，不构造临时的键节点
+                for (auto [key, value] : node) {
+                    if (key.is_scalar() && key.scalar_view() == segment.key)
+                        return select(value, pos + 1, result, first_only);
+                }
+            } else if (
+                    node.is_seq() && segment.index >= 0 &&
+                    segment.index < node.size()) {
+                return select(
+                        node[static_cast<uint32_t>(segment.index)], pos + 1,
+                        result, first_only);
+            }
+            return false;
+        case Path_Segment_Type::ANY:
+            for (const Node &child : node) {
+                if (select(child, pos + 1, result, first_only))
+                    return true;
+            }
+            return false;
+        case Path_Segment_Type::RECURSIVE:
+            if (select(node, pos + 1, result, first_only))
+                return true;
+
+            for (const Node &child : node) {
+                if (select(child, pos, result, first_only))
+                    return true;
+            }
+            return false;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief   判断路径项与位置项是否匹配
+     * @param   segment     路径项，不能为 RECURSIVE
+     * @param   component   位置项
+     * @return  bool
+     */
+    static bool match_component(
+            const Path_Segment &segment,
+            const Path_Component &component)
+    {
+        if (segment.type == Path_Segment_Type::ANY)
+            return true;
+
+        if (component.index >= 0)
+            return segment.index == component.index;
+
+        return component.valid && component.key == segment.key;
+    }
+
+    bool Path::match(
+            size_t pos,
+            const std::vector<Path_Component> &location,
+            size_t depth) const
+    {
+        if (pos == segments_.size())
+            return depth == location.size();
+
+        auto &segment = segments_[pos];
+        if (segment.type == Path_Segment_Type::RECURSIVE) {
+            // ** 匹配任意个位置项
+            for (size_t i = depth; i <= location.size(); i++) {
+                if (match(pos + 1, location, i))
+                    return true;
+            }
+            return false;
+        }
+
+        if (depth == location.size() ||
+            !match_component(segment, location[depth]))
+            return false;
+
+        return match(pos + 1, location, depth + 1);
+    }
+
+    bool Path::prefix(
+            size_t pos,
+            const std::vector<Path_Component> &location,
+            size_t depth) const
+    {
+        // 位置已全部匹配，还有剩余路径项时子孙节点可能匹配
+        if (depth == location.size())
+            return pos < segments_.size();
+
+        if (pos == segments_.size())
+            return false;
+
+        auto &segment = segments_[pos];
+        if (segment.type == Path_Segment_Type::RECURSIVE)
+            return true;
+
+        if (!match_component(segment, location[depth]))
+            return false;
+
+        return prefix(pos + 1, location, depth + 1);
+    }
+
+    Selector::Selector(Path path): paths_{std::move(path)} {}
+
+    Selector::Selector(std::vector<Path> paths): paths_(std::move(paths)) {}
+
+    Selector::Selector(std::initializer_list<Path> paths): paths_(paths) {}
+
+    bool Selector::match(const Location &location) const
+    {
+        if (predicate_)
+            return predicate_(location);
+
+        for (auto &path : paths_) {
+            if (path.match(location))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool Selector::prefix(const Location &location) const
+    {
+        if (predicate_)
+            return true;
+
+        for (auto &path : paths_) {
+            if (path.prefix(location))
+                return true;
+        }
+
+        return false;
+    }
+
+} // namespace cyaml
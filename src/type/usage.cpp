@@ -0,0 +1,243 @@
+/**
+ * @file        usage.cpp
+ * @brief       节点树内存统计
+ * @details     主要包含 memory_usage 函数实现
+ * @date        2026-10-18
+ */
+
+#include "cyaml/type/node/usage.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace cyaml
+{
+    /**
+     * @brief   allocate_shared 控制块的估算大小
+     * @details 虚表指针、两个引用计数和保存的 polymorphic_allocator
+     */
+    static constexpr size_t SHARED_BLOCK_BYTES =
+            sizeof(void *) + 2 * sizeof(int) +
+            sizeof(std::pmr::polymorphic_allocator<char>);
+
+    /**
+     * @class   Usage_Counter
+     * @brief   遍历节点树并累计内存统计
+     */
+    class Usage_Counter
+    {
+    private:
+        Memory_Usage &usage_;
+        size_t limit_; // 记录的最大集合个数
+
+        std::unordered_set<const Node_Data *> datas_;     // 已统计的数据
+        std::unordered_set<const std::string *> buffers_; // 已统计的源数据
+        std::vector<std::string> path_;                   // 当前路径
+
+    public:
+        Usage_Counter(Memory_Usage &usage, size_t limit)
+            : usage_(usage), limit_(limit)
+        {
+        }
+
+        /**
+         * @brief   统计节点及其子孙节点
+         * @param   node    节点
+         * @param   depth   节点层数
+         * @return  void
+         */
+        void visit(const Node &node, size_t depth)
+        {
+            usage_.node_bytes += sizeof(Node) + SHARED_BLOCK_BYTES;
+            usage_.max_depth = std::max(usage_.max_depth, depth);
+
+            switch (node.type_) {
+            case Node_Type::MAP:
+                usage_.map_count++;
+                break;
+            case Node_Type::SEQ:
+                usage_.seq_count++;
+                break;
+            case Node_Type::SCALAR:
+                usage_.scalar_count++;
+                break;
+            case Node_Type::NONE:
+                usage_.null_count++;
+                break;
+            }
+
+            // 直接读取数据成员，避免构建延迟加载的子节点
+            const Node_Data *data = node.data_.get();
+            if (!account(data)) {
+                usage_.shared_count++;
+                return;
+            }
+
+            if (data->is_lazy()) {
+                usage_.lazy_count++;
+                return;
+            }
+
+            if (data->source) {
+                data = data->source.get();
+                if (!account(data)) {
+                    usage_.shared_count++;
+                    return;
+                }
+            }
+
+            if (node.type_ == Node_Type::MAP) {
+                record(node.type_, data->map.size());
+                for (auto &[key, value] : data->map) {
+                    path_.push_back("?");
+                    visit(*key, depth + 1);
+                    path_.back() = escape(*key);
+                    visit(*value, depth + 1);
+                    path_.pop_back();
+                }
+            } else if (node.type_ == Node_Type::SEQ) {
+                record(node.type_, data->seq.size());
+                for (size_t i = 0; i < data->seq.size(); i++) {
+                    path_.push_back(std::to_string(i));
+                    visit(*data->seq[i], depth + 1);
+                    path_.pop_back();
+                }
+            }
+        }
+
+        /**
+         * @brief   按大小降序整理最大集合列表
+         * @return  void
+         */
+        void finish()
+        {
+            auto &largest = usage_.largest;
+            std::sort_heap(largest.begin(), largest.end(), larger);
+        }
+
+    private:
+        /**
+         * @brief   按子节点数降序比较集合，用于维护最小堆
+         * @param   a   集合统计
+         * @param   b   集合统计
+         * @return  bool
+         */
+        static bool larger(
+                const Container_Usage &a,
+                const Container_Usage &b)
+        {
+            return a.size > b.size;
+        }
+
+        /**
+         * @brief   统计节点数据自身占用的内存
+         * @param   data    节点数据
+         * @return  bool
+         * @retval  false:  数据已统计过
+         */
+        bool account(const Node_Data *data)
+        {
+            if (!datas_.insert(data).second)
+                return false;
+
+            usage_.data_bytes += sizeof(Node_Data) + SHARED_BLOCK_BYTES;
+            usage_.container_bytes += data->map.capacity() * sizeof(KV_Pair) +
+                                      data->seq.capacity() * sizeof(Node_Ptr);
+
+            // 短字符串保存在 string 对象内部，没有堆内存
+            auto begin = reinterpret_cast<const char *>(&data->scalar);
+            auto text = data->scalar.data();
+            if (text < begin || text >= begin + sizeof(data->scalar))
+                usage_.scalar_bytes += data->scalar.capacity() + 1;
+
+            // 桶数组和每个元素的链表节点
+            if (!data->refs.empty()) {
+                usage_.ref_bytes +=
+                        data->refs.bucket_count() * sizeof(void *) +
+                        data->refs.size() * 2 * sizeof(void *);
+            }
+
+            // 从源数据构建的附加状态，已构建的集合保留范围用于保留格式输出
+            auto *state = data->tracked;
+            if (!state)
+                return true;
+
+            usage_.source_bytes += sizeof(Source_State);
+            auto range = state->lazy ? state->lazy.get() : state->span.get();
+            if (range) {
+                usage_.source_bytes +=
+                        sizeof(Lazy_Range) + SHARED_BLOCK_BYTES +
+                        range->entries.capacity() * sizeof(uint32_t);
+                auto buffer = range->buffer.get();
+                if (buffer && buffers_.insert(buffer).second) {
+                    usage_.source_bytes += sizeof(std::string) +
+                                           buffer->capacity() +
+                                           SHARED_BLOCK_BYTES;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief   转义路径项
+         * @param   key     键
+         * @return  std::string
+         */
+        static std::string escape(const Node &key)
+        {
+            if (!key.is_scalar())
+                return "?";
+
+            std::string result;
+            for (char c : key.scalar_view()) {
+                if (c == '~')
+                    result += "~0";
+                else if (c == '/')
+                    result += "~1";
+                else
+                    result += c;
+            }
+            return result;
+        }
+
+        /**
+         * @brief   记录集合大小，只保留最大的若干个
+         * @param   type    集合类型
+         * @param   size    直接子节点数
+         * @return  void
+         */
+        void record(Node_Type type, size_t size)
+        {
+            auto &largest = usage_.largest;
+            if (limit_ == 0)
+                return;
+
+            if (largest.size() == limit_) {
+                if (size <= largest.front().size)
+                    return;
+
+                std::pop_heap(largest.begin(), largest.end(), larger);
+                largest.pop_back();
+            }
+
+            std::string path;
+            for (auto &component : path_) {
+                path += '/';
+                path += component;
+            }
+
+            largest.push_back({std::move(path), type, size});
+            std::push_heap(largest.begin(), largest.end(), larger);
+        }
+    };
+
+    Memory_Usage memory_usage(const Node &node, size_t largest)
+    {
+        Memory_Usage usage;
+        Usage_Counter counter(usage, largest);
+        counter.visit(node, 1);
+        counter.finish();
+        return usage;
+    }
+
+} // namespace cyaml
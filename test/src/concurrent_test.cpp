@@ -0,0 +1,170 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory_resource>
+#include "cyaml/cyaml.h"
+#include "gtest/gtest.h"
+
+// 该测试需要配合 -DENABLE_TSAN=ON 编译，由 ThreadSanitizer 检查数据竞争
+class Concurrent_Test: public testing::Test
+{
+public:
+    const int thread_count = 8;
+    const int loop_count = 2000;
+
+    static void SetUpTestSuite()
+    {
+        std::cout << "concurrent test start..." << std::endl;
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::cout << "concurrent test finish" << std::endl;
+    }
+};
+
+TEST_F(Concurrent_Test, frozen_read)
+{
+    cyaml::Node config = cyaml::load(
+            "limits: {max_conns: 100, timeout: 30}\n"
+            "hosts: [a, b, c]\n"
+            "base: &base {x: 1}\n"
+            "derived: *base\n");
+    config.freeze();
+    ASSERT_TRUE(config.is_frozen());
+
+    cyaml::Node other = config.clone();
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < loop_count; i++) {
+                const cyaml::Node &c = config;
+                if (c["limits"]["max_conns"].as<int>() != 100)
+                    errors++;
+
+                // 复制节点、遍历 key、非 const 查找都不应修改共享状态
+                cyaml::Node hosts = config["hosts"];
+                if (hosts.size() != 3 || hosts[2].as<std::string>() != "c")
+                    errors++;
+
+                for (auto &key : c.keys()) {
+                    if (!c.contain(key))
+                        errors++;
+                }
+
+                // 冻结时已计算哈希，比较不写入缓存
+                if (c != other || c["limits"] == c["hosts"])
+                    errors++;
+
+                cyaml::Node derived = c["derived"];
+                if (derived["x"].as<int>() != 1)
+                    errors++;
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(errors, 0);
+}
+
+TEST_F(Concurrent_Test, frozen_modify)
+{
+    cyaml::Node config = cyaml::load("{a: 1, b: [1, 2]}");
+    config.freeze();
+
+    EXPECT_THROW(config["a"] = 2, cyaml::Frozen_Exception);
+    EXPECT_THROW(config["c"], cyaml::Frozen_Exception);
+    EXPECT_THROW(config["b"].push_back(3), cyaml::Frozen_Exception);
+    EXPECT_THROW(config.erase(cyaml::Node("a")), cyaml::Frozen_Exception);
+    // 与越界下标相同，不存在的键不修改节点，直接返回 false
+    EXPECT_FALSE(config.erase(cyaml::Node("c")));
+    EXPECT_FALSE(config["b"].erase(2));
+    EXPECT_THROW(
+            config["b"].set_style(cyaml::Node_Style::FLOW),
+            cyaml::Frozen_Exception);
+
+    // 复制出的节点可以重新绑定，但不会影响冻结的节点树
+    cyaml::Node a = config["a"];
+    a = 3;
+    EXPECT_EQ(a.as<int>(), 3);
+    EXPECT_EQ(config["a"].as<int>(), 1);
+
+    // 克隆得到可修改的副本
+    cyaml::Node copy = config["b"].clone();
+    EXPECT_FALSE(copy.is_frozen());
+    copy.push_back(3);
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(config["b"].size(), 2);
+
+    // 各线程从自己的内存资源克隆，不使用原节点树的非线程安全资源
+    std::pmr::monotonic_buffer_resource source;
+    cyaml::Node shared = cyaml::load("{a: {b: [1, 2]}, c: 3}", &source);
+    shared.freeze();
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            std::pmr::monotonic_buffer_resource local;
+            for (int i = 0; i < loop_count / 10; i++) {
+                cyaml::Node mine = shared.clone(&local);
+                mine["a"]["b"].push_back(t);
+                if (mine.resource() != &local ||
+                    mine["a"]["b"].resource() != &local ||
+                    mine["a"]["b"].size() != 3)
+                    errors++;
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(shared["a"]["b"].size(), 2);
+}
+
+TEST_F(Concurrent_Test, key_table)
+{
+    cyaml::Key_Table &table = cyaml::Key_Table::global();
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            auto name = table.key("name");
+            for (int i = 0; i < loop_count / 10; i++) {
+                auto node = cyaml::load(
+                        "name: n" + std::to_string(t) +
+                                "\nport: 80\nkey" + std::to_string(i % 5) +
+                                ": 1\n",
+                        table);
+                if (node[name].as<std::string>() != "n" + std::to_string(t))
+                    errors++;
+                if (node["port"].as<int>() != 80)
+                    errors++;
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_GE(table.size(), 7);
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
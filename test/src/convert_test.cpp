@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "cyaml/cyaml.h"
+#include "gtest/gtest.h"
+
+TEST(convert_test, integral)
+{
+    auto node = cyaml::load(
+            "{small: -128, byte: 255, neg: -1, big: 18446744073709551615, "
+            "hex: 0xff, float: 1.5, text: 12abc}");
+
+    EXPECT_EQ(node["small"].as<int8_t>(), -128);
+    EXPECT_EQ(node["byte"].as<uint8_t>(), 255);
+    EXPECT_EQ(node["hex"].as<uint16_t>(), 255);
+    EXPECT_EQ(node["neg"].as<int64_t>(), -1);
+    EXPECT_EQ(
+            node["big"].as<uint64_t>(),
+            std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(node["byte"].as<size_t>(), 255u);
+
+    // 超出范围或不是整数时抛出异常
+    EXPECT_THROW(node["byte"].as<int8_t>(), cyaml::Convertion_Exception);
+    EXPECT_THROW(node["neg"].as<uint32_t>(), cyaml::Convertion_Exception);
+    EXPECT_THROW(node["big"].as<int64_t>(), cyaml::Convertion_Exception);
+    EXPECT_THROW(node["float"].as<int>(), cyaml::Convertion_Exception);
+    EXPECT_THROW(node["text"].as<int>(), cyaml::Convertion_Exception);
+
+    cyaml::Node seq;
+    seq.push_back(std::numeric_limits<int64_t>::min());
+    seq.push_back(std::numeric_limits<uint64_t>::max());
+    seq.push_back(static_cast<int8_t>(-5));
+    EXPECT_EQ(seq[0].as<std::string>(), "-9223372036854775808");
+    EXPECT_EQ(seq[1].as<std::string>(), "18446744073709551615");
+    EXPECT_EQ(seq[2].as<int>(), -5);
+}
+
+TEST(convert_test, floating)
+{
+    auto node = cyaml::load(
+            "{f: 2.2, d: 0.1, i: 3, inf: -.inf, nan: .nan, s: abc}");
+
+    EXPECT_FLOAT_EQ(node["f"].as<float>(), 2.2f);
+    EXPECT_DOUBLE_EQ(node["d"].as<double>(), 0.1);
+    EXPECT_EQ(node["d"].as<long double>(), 0.1L);
+    EXPECT_DOUBLE_EQ(node["i"].as<double>(), 3.0);
+    EXPECT_EQ(
+            node["inf"].as<double>(),
+            -std::numeric_limits<double>::infinity());
+    EXPECT_TRUE(std::isnan(node["nan"].as<double>()));
+    EXPECT_THROW(node["s"].as<double>(), cyaml::Convertion_Exception);
+
+    // 超出 double 范围时上溢为无穷大，下溢为 0；缩小为 float 时检查范围
+    auto range = cyaml::load(
+            "{over: 1e400, neg: -1e400, under: 1e-400, small: 0.0001e-320, "
+            "big: 3.5e38, frac: 12345.6e-400}");
+    EXPECT_EQ(
+            range["over"].as<double>(),
+            std::numeric_limits<double>::infinity());
+    EXPECT_EQ(
+            range["neg"].as<double>(),
+            -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(range["under"].as<double>(), 0.0);
+    EXPECT_EQ(range["small"].as<double>(), 0.0);
+    EXPECT_EQ(range["frac"].as<double>(), 0.0);
+    EXPECT_EQ(range["big"].as<double>(), 3.5e38);
+    EXPECT_THROW(range["big"].as<float>(), cyaml::Convertion_Exception);
+    EXPECT_TRUE(std::isinf(range["over"].as<float>()));
+    if (std::numeric_limits<long double>::max_exponent10 > 400) {
+        EXPECT_EQ(range["neg"].as<long double>(), -1e400L);
+    }
+    EXPECT_TRUE(std::isnan(node["nan"].as<long double>()));
+    EXPECT_EQ(
+            node["inf"].as<long double>(),
+            -std::numeric_limits<long double>::infinity());
+
+    // 输出最短的可还原表示
+    cyaml::Node seq;
+    seq.push_back(0.1);
+    seq.push_back(2.2f);
+    seq.push_back(1.0);
+    seq.push_back(std::numeric_limits<double>::infinity());
+    seq.push_back(1e300);
+    EXPECT_EQ(seq[0].as<std::string>(), "0.1");
+    EXPECT_EQ(seq[1].as<std::string>(), "2.2");
+    EXPECT_EQ(seq[2].as<std::string>(), "1.0");
+    EXPECT_EQ(seq[3].as<std::string>(), ".inf");
+    EXPECT_EQ(seq[4].as<double>(), 1e300);
+
+    double value = 0.30000000000000004;
+    cyaml::Node round_trip;
+    round_trip = value;
+    EXPECT_EQ(round_trip.as<double>(), value);
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
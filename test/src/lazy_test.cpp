@@ -0,0 +1,251 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory_resource>
+#include "cyaml/cyaml.h"
+#include "gtest/gtest.h"
+
+/**
+ * @class   Counting_Resource
+ * @brief   统计分配次数的内存资源
+ */
+class Counting_Resource: public std::pmr::memory_resource
+{
+public:
+    size_t count = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        count++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+            const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+class Lazy_Test: public testing::Test
+{
+public:
+    const std::string test_case_dirname = "../test/test_case/parser_test/";
+
+    const std::string input =
+            "server:\n"
+            "  host: localhost\n"
+            "  ports: [80, 443]\n"
+            "  tls:\n"
+            "    cert: a.pem\n"
+            "\n"
+            "    # 注释\n"
+            "    key: |\n"
+            "      line 1\n"
+            "\n"
+            "      line 2\n"
+            "clients:\n"
+            "- name: a\n"
+            "  tags:\n"
+            "  - x\n"
+            "  - - y\n"
+            "    - z\n"
+            "-\n"
+            "- name: \"long\n"
+            "    quoted\"\n"
+            "  note: plain\n"
+            "    continued\n"
+            "? [complex, key]\n"
+            ": {port: 3}\n"
+            "? - block\n"
+            "  - key\n"
+            ":\n"
+            "  value: 1\n"
+            "empty:\n"
+            "last:\n"
+            "  - 1\n"
+            "...\n"
+            "---\n"
+            "second: document\n";
+
+    static void SetUpTestSuite()
+    {
+        std::cout << "lazy test start..." << std::endl;
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::cout << "lazy test finish" << std::endl;
+    }
+};
+
+TEST_F(Lazy_Test, equal)
+{
+    auto lazy = cyaml::load_lazy(input);
+    auto eager = cyaml::load(input);
+    EXPECT_EQ(lazy, eager);
+    EXPECT_EQ(cyaml::dump(lazy), cyaml::dump(eager));
+    EXPECT_EQ(
+            lazy["server"]["tls"]["key"].as<std::string>(),
+            "line 1\n\nline 2\n");
+    EXPECT_TRUE(lazy["clients"][1].is_null());
+    EXPECT_EQ(
+            lazy["clients"][2]["note"].as<std::string>(), "plain continued");
+
+    // 跳过 utf-8 BOM 后偏移仍与源数据一致
+    std::string bom = "\xEF\xBB\xBF"
+                      "a:\n"
+                      "  b: 1\n"
+                      "c:\n"
+                      "- 2\n";
+    EXPECT_EQ(cyaml::load_lazy(bom), cyaml::load(bom));
+
+    // 缩进较深的集合在重新解析时补齐多段空格
+    std::string deep;
+    for (int i = 0; i < 40; i++)
+        deep += std::string(2 * i, ' ') + "k" + std::to_string(i) + ":\n";
+    deep += std::string(80, ' ') + "- a\n" + std::string(80, ' ') + "- b\n";
+    auto deep_lazy = cyaml::load_lazy(deep);
+    EXPECT_EQ(deep_lazy, cyaml::load(deep));
+    EXPECT_EQ(cyaml::dump_preserved(deep_lazy), deep);
+
+    // block 集合之后直接以 "---" 开始下一个文档时只加载第一个文档
+    for (std::string multi :
+         {"a:\n  b: 1\n---\nc: 2\n", "---\na:\n  b: 1\n---\nc: 2\n",
+          "- 1\n- - 2\n---\n- 3\n"}) {
+        auto multi_lazy = cyaml::load_lazy(multi);
+        EXPECT_EQ(multi_lazy, cyaml::load(multi)) << multi;
+        EXPECT_EQ(multi_lazy, cyaml::load_all(multi)[0]) << multi;
+    }
+
+    for (auto name :
+         {"anchor_alias", "complex_key", "empty_document1", "flow", "json",
+          "json_style", "multi_documents", "nested_key", "node"}) {
+        std::ifstream ifs(test_case_dirname + name + ".in");
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        EXPECT_EQ(cyaml::load_lazy(ss.str()), cyaml::load(ss.str())) << name;
+    }
+}
+
+TEST_F(Lazy_Test, on_demand)
+{
+    Counting_Resource eager_resource;
+    auto eager = cyaml::load(input, &eager_resource);
+
+    Counting_Resource lazy_resource;
+    auto lazy = cyaml::load_lazy(input, &lazy_resource);
+    size_t loaded = lazy_resource.count;
+    EXPECT_LT(loaded, eager_resource.count);
+
+    // 只有从源数据构建的节点数据保存附加状态
+    EXPECT_EQ(cyaml::memory_usage(eager).source_bytes, 0);
+    EXPECT_GT(cyaml::memory_usage(lazy).source_bytes, 0);
+
+    // 只访问类型和根节点的直接子节点不会构建子节点
+    EXPECT_TRUE(lazy["server"].is_map());
+    EXPECT_EQ(lazy_resource.count, loaded);
+
+    EXPECT_EQ(lazy["server"]["host"].as<std::string>(), "localhost");
+    EXPECT_GT(lazy_resource.count, loaded);
+    EXPECT_EQ(lazy, eager);
+}
+
+TEST_F(Lazy_Test, modify)
+{
+    auto root = cyaml::load_lazy(input);
+    auto copy = root.clone();
+    EXPECT_EQ(copy, cyaml::load(input));
+
+    root["server"]["tls"]["cert"] = "b.pem";
+    root["clients"][0]["tags"].push_back("w");
+    EXPECT_EQ(root["server"]["tls"]["cert"].as<std::string>(), "b.pem");
+    EXPECT_EQ(root["clients"][0]["tags"].size(), 3);
+    EXPECT_EQ(copy["server"]["tls"]["cert"].as<std::string>(), "a.pem");
+
+    auto frozen = cyaml::load_lazy(input);
+    frozen.freeze();
+    EXPECT_EQ(frozen, cyaml::load(input));
+
+    // 重复键在构建子节点时报错，位置为源数据中的行
+    auto duplicated = cyaml::load_lazy("a:\n  b: 1\n  b: 2\n");
+    try {
+        duplicated["a"].size();
+        FAIL();
+    } catch (const cyaml::Representation_Exception &e) {
+        EXPECT_NE(std::string(e.what()).find("3"), std::string::npos);
+    }
+    EXPECT_THROW(duplicated["a"].size(), cyaml::Representation_Exception);
+}
+
+TEST_F(Lazy_Test, preserve)
+{
+    // 未修改时与源数据完全相同，构建全部子节点后仍然相同
+    auto root = cyaml::load_lazy(input);
+    EXPECT_EQ(cyaml::dump_preserved(root), input);
+    EXPECT_EQ(root, cyaml::load(input));
+    EXPECT_EQ(cyaml::dump_preserved(root), input);
+
+    // 只重新输出修改过的条目，注释、空行和其他条目保持不变
+    root["server"]["tls"]["cert"] = "b.pem";
+    std::string expected = input;
+    expected.replace(expected.find("a.pem"), 5, "b.pem");
+    EXPECT_EQ(cyaml::dump_preserved(root), expected);
+
+    root["clients"][0]["tags"].push_back("w");
+    expected.insert(expected.find("-\n- name"), "  - w\n");
+    EXPECT_EQ(cyaml::dump_preserved(root), expected);
+
+    root.erase(cyaml::Node("empty"));
+    expected.erase(expected.find("empty:\n"), 7);
+    root["new"] = "x";
+    expected.insert(expected.find("...\n"), "new: x\n");
+    EXPECT_EQ(cyaml::dump_preserved(root), expected);
+    EXPECT_EQ(cyaml::load(cyaml::dump_preserved(root)), root);
+
+    // 替换为其他节点后按 dump 的格式输出该条目
+    root["server"]["ports"] = root["clients"][0]["tags"];
+    auto output = cyaml::dump_preserved(root);
+    EXPECT_NE(output.find("  ports: \n    - x\n"), std::string::npos);
+    EXPECT_NE(output.find("    # 注释\n"), std::string::npos);
+    EXPECT_EQ(cyaml::load(output), root);
+
+    // block 根节点之后直接以 "---" 开始的文档同样原样保留
+    std::string multi = "# head\n"
+                        "a:\n"
+                        "  b: 1\n"
+                        "c: [2]\n"
+                        "---\n"
+                        "d:   3 # later\n";
+    auto first = cyaml::load_lazy(multi);
+    EXPECT_EQ(cyaml::dump_preserved(first), multi);
+    first["a"]["b"] = 4;
+    first["e"] = 5;
+    EXPECT_EQ(
+            cyaml::dump_preserved(first),
+            "# head\n"
+            "a:\n"
+            "  b: 4\n"
+            "c: [2]\n"
+            "e: 5\n"
+            "---\n"
+            "d:   3 # later\n");
+
+    // 不是延迟加载的节点与 dump 相同
+    auto eager = cyaml::load(input);
+    EXPECT_EQ(cyaml::dump_preserved(eager), cyaml::dump(eager));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
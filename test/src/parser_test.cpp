@@ -2,9 +2,40 @@
 #include <fstream>
 #include <string>
 #include <exception>
+#include <memory_resource>
+#include <utility>
+#include <unordered_set>
 #include "cyaml/cyaml.h"
 #include "gtest/gtest.h"
 
+/**
+ * @class   Counting_Resource
+ * @brief   统计分配次数的内存资源
+ */
+class Counting_Resource: public std::pmr::memory_resource
+{
+public:
+    size_t count = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        count++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+            const noexcept override
+    {
+        return this == &other;
+    }
+};
+
 class Parser_Test: public testing::Test
 {
 public:
@@ -222,6 +253,493 @@ TEST_F(Parser_Test, multi_documents)
     EXPECT_EQ(nodes[3].as<std::string>(), "forth document");
 }
 
+TEST_F(Parser_Test, memory_resource)
+{
+    // 上游为 null_memory_resource，节点树的任何分配超出缓冲区都会抛出异常
+    char buffer[64 * 1024];
+    std::pmr::monotonic_buffer_resource resource(
+            buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    std::ifstream input_in(test_case_dirname + "anchor_alias.in");
+    ASSERT_TRUE(input_in.is_open());
+
+    cyaml::Node node = cyaml::load(input_in, &resource);
+    EXPECT_EQ(node.resource(), &resource);
+    EXPECT_EQ(node["a"].resource(), &resource);
+    EXPECT_EQ(node["b"]["b1"].as<int>(), 2);
+
+    // 新插入的子节点使用父节点的内存资源
+    EXPECT_TRUE(node["b"]["b4"].is_null());
+    EXPECT_EQ(node["b"]["b4"].resource(), &resource);
+
+    auto nodes = cyaml::load_all("[1, 2]\n---\n{a: b}", &resource);
+    ASSERT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes[0][1].as<int>(), 2);
+    EXPECT_EQ(nodes[1]["a"].resource(), &resource);
+
+    // "---" 结束上一个文档中未闭合的 block 集合
+    nodes = cyaml::load_all("a:\n  b: 1\n---\n- 2\n");
+    ASSERT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes[0]["a"]["b"].as<int>(), 1);
+    EXPECT_EQ(nodes[1][0].as<int>(), 2);
+}
+
+TEST_F(Parser_Test, scalar_value)
+{
+    auto node = cyaml::load(
+            "{i: -42, o: 0o17, h: 0x1f, f: 1.5e3, inf: -.inf, b: True, "
+            "n: ~, s: hello, big: 99999999999999999999, v: 1.2.3}");
+
+    EXPECT_EQ(node["i"].resolve().type, cyaml::Scalar_Type::INT);
+    EXPECT_EQ(node["i"].resolve().integer, -42);
+    EXPECT_EQ(node["o"].resolve().integer, 15);
+    EXPECT_EQ(node["h"].resolve().integer, 31);
+    EXPECT_EQ(node["f"].resolve().type, cyaml::Scalar_Type::FLOAT);
+    EXPECT_DOUBLE_EQ(node["f"].resolve().real, 1500.0);
+    EXPECT_LT(node["inf"].resolve().real, 0);
+    EXPECT_EQ(node["b"].resolve().type, cyaml::Scalar_Type::BOOL);
+    EXPECT_TRUE(node["b"].as<bool>());
+    EXPECT_EQ(node["n"].resolve().type, cyaml::Scalar_Type::NONE);
+    EXPECT_EQ(node["s"].resolve().type, cyaml::Scalar_Type::STRING);
+    EXPECT_EQ(node["big"].resolve().type, cyaml::Scalar_Type::FLOAT);
+    EXPECT_EQ(node["v"].resolve().type, cyaml::Scalar_Type::STRING);
+
+    // 重复取值直接使用缓存
+    EXPECT_EQ(node["i"].as<int>(), -42);
+    EXPECT_EQ(node["i"].as<int>(), -42);
+    EXPECT_FLOAT_EQ(node["f"].as<float>(), 1500.0);
+
+    // 修改后缓存失效
+    node["i"] = 7;
+    EXPECT_EQ(node["i"].as<int>(), 7);
+    node["s"].clear();
+    EXPECT_EQ(node["s"].resolve().type, cyaml::Scalar_Type::NONE);
+}
+
+TEST_F(Parser_Test, move_and_emplace)
+{
+    cyaml::Node seq;
+    seq.reserve(4);
+    seq.emplace_back(1);
+    seq.emplace_back("two");
+    seq.emplace_back(cyaml::Node_Type::MAP);
+    seq.emplace_back();
+
+    cyaml::Node item;
+    item.push_back(3);
+    ASSERT_TRUE(seq.push_back(std::move(item)));
+
+    ASSERT_EQ(seq.size(), 5);
+    EXPECT_EQ(seq[0].as<int>(), 1);
+    EXPECT_EQ(seq[1].as<std::string>(), "two");
+    EXPECT_TRUE(seq[2].is_map());
+    EXPECT_TRUE(seq[3].is_null());
+    EXPECT_EQ(seq[4][0].as<int>(), 3);
+
+    // 移动后的节点为空值，可以重新赋值
+    EXPECT_TRUE(item.is_null());
+    item = 4;
+    EXPECT_EQ(item.as<int>(), 4);
+    EXPECT_EQ(seq[4][0].as<int>(), 3);
+
+    // 从节点树中移出子节点后，原位置为空值
+    auto tree = cyaml::load("a: [1, 2]\nb: x\n");
+    cyaml::Node moved(std::move(tree["a"]));
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_TRUE(tree["a"].is_null());
+    EXPECT_EQ(cyaml::dump(tree), "a: null\nb: x\n");
+
+    // 冻结节点树的子节点只能复制，不会被修改
+    auto frozen = cyaml::load("{a: [1, 2]}");
+    frozen.freeze();
+    cyaml::Node shared;
+    shared.push_back(std::move(const_cast<cyaml::Node &>(frozen["a"])));
+    EXPECT_EQ(frozen["a"].size(), 2);
+    EXPECT_EQ(shared[0].size(), 2);
+
+    cyaml::Node map;
+    map.reserve(3);
+    ASSERT_TRUE(map.emplace("a", 1.5));
+    ASSERT_TRUE(map.emplace(2, "b"));
+    ASSERT_TRUE(map.insert(cyaml::Node("c"), std::move(seq)));
+    EXPECT_DOUBLE_EQ(map["a"].as<double>(), 1.5);
+    EXPECT_EQ(map["2"].as<std::string>(), "b");
+    EXPECT_EQ(map["c"].size(), 5);
+    EXPECT_FALSE(map.emplace_back(1));
+}
+
+TEST_F(Parser_Test, clone)
+{
+    // 深复制
+    auto node = cyaml::load("{a: 1, b: [2, 3]}");
+    cyaml::Node copy = node.clone();
+    EXPECT_EQ(copy, node);
+    EXPECT_EQ(copy["a"].as<int>(), 1);
+    copy["b"].push_back(4);
+    EXPECT_EQ(node["b"].size(), 2);
+
+    // 冻结节点的写时复制克隆
+    Counting_Resource resource;
+    std::string input = "{limits: {max_conns: 100, timeout: 30}, hosts: [";
+    for (int i = 0; i < 1000; i++) {
+        input += "host" + std::to_string(i) + ", ";
+    }
+    input += "last]}";
+
+    cyaml::Node base = cyaml::load(input, &resource);
+    base.freeze();
+
+    size_t count = resource.count;
+    cyaml::Node tenant = base.clone();
+    EXPECT_LE(resource.count - count, 8);
+    EXPECT_EQ(tenant, base);
+    EXPECT_EQ(tenant["hosts"].size(), 1001);
+
+    // 修改时只复制根到修改位置的路径，hosts 仍然共享
+    count = resource.count;
+    tenant["limits"]["max_conns"] = 200;
+    tenant["limits"]["extra"] = 1;
+    EXPECT_LE(resource.count - count, 32);
+    EXPECT_EQ(tenant["limits"]["max_conns"].as<int>(), 200);
+    EXPECT_EQ(base["limits"]["max_conns"].as<int>(), 100);
+    EXPECT_FALSE(base["limits"].contain("extra"));
+    EXPECT_EQ(tenant["hosts"], base["hosts"]);
+
+    cyaml::Node alias = tenant["hosts"];
+    alias.push_back("new");
+    EXPECT_EQ(tenant["hosts"].size(), 1002);
+    EXPECT_EQ(base["hosts"].size(), 1001);
+}
+
+TEST_F(Parser_Test, assign_after_reset)
+{
+    // 空节点通过 operator[] 转换为 map 后仍然可以重新赋值
+    cyaml::Node node;
+    node["a"] = 1;
+    node = cyaml::load("[1, 2]");
+    EXPECT_TRUE(node.is_seq());
+    EXPECT_EQ(node.size(), 2);
+
+    // 转换后的子节点重新赋值后父节点读取到新值
+    cyaml::Node root;
+    root["a"]["b"] = 1;
+    root["a"] = cyaml::load("[3]");
+    EXPECT_EQ(cyaml::dump(root), "a: [3]\n");
+
+    // push_back 和 insert 转换的空节点同样可以重新赋值
+    cyaml::Node seq;
+    seq.push_back(1);
+    seq = cyaml::load("{a: 1}");
+    EXPECT_TRUE(seq.is_map());
+    cyaml::Node inserted;
+    inserted.insert(0, cyaml::Node("1"));
+    inserted = cyaml::load("{b: 2}");
+    ASSERT_TRUE(inserted.is_map());
+    EXPECT_EQ(inserted["b"].as<int>(), 2);
+}
+
+TEST_F(Parser_Test, iterator)
+{
+    auto node = cyaml::load("{a: 1, b: 2, c: [x, y, z]}");
+
+    std::string keys;
+    int sum = 0;
+    for (auto [key, value] : std::as_const(node)) {
+        keys += key.as<std::string>();
+        if (value.is_scalar())
+            sum += value.as<int>();
+    }
+    EXPECT_EQ(keys, "abc");
+    EXPECT_EQ(sum, 3);
+
+    std::string elems;
+    for (const cyaml::Node &elem : node["c"]) {
+        elems += elem.as<std::string>();
+    }
+    EXPECT_EQ(elems, "xyz");
+
+    // 通过非 const 迭代器修改值
+    for (auto it = node.begin(); it != node.end(); ++it) {
+        if (it.key().as<std::string>() == "b")
+            it.value() = 20;
+    }
+    EXPECT_EQ(node["b"].as<int>(), 20);
+
+    // 标量和空值节点没有元素
+    cyaml::Node scalar("s");
+    EXPECT_TRUE(scalar.begin() == scalar.end());
+    cyaml::Node null;
+    EXPECT_TRUE(null.begin() == null.end());
+
+    // 冻结节点的克隆在非 const 遍历前复制数据，不影响原节点
+    node.freeze();
+    cyaml::Node copy = node.clone();
+    for (cyaml::Node &elem : copy["c"]) {
+        elem = "w";
+    }
+    EXPECT_EQ(copy["c"][0].as<std::string>(), "w");
+    EXPECT_EQ(node["c"][0].as<std::string>(), "x");
+}
+
+TEST_F(Parser_Test, hash)
+{
+    auto n1 = cyaml::load("{a: 1, b: [x, y], c: {d: null}}");
+    auto n2 = cyaml::load("{a: 1, b: [x, y], c: {d: null}}");
+    EXPECT_EQ(n1.hash(), n2.hash());
+    EXPECT_EQ(n1, n2);
+
+    // 修改后哈希缓存失效
+    n2["b"].push_back("z");
+    EXPECT_NE(n1.hash(), n2.hash());
+    EXPECT_NE(n1, n2);
+
+    cyaml::Node b = n2["b"];
+    b = cyaml::load("[x, y]");
+    EXPECT_EQ(n1.hash(), n2.hash());
+    EXPECT_EQ(n1, n2);
+
+    n2["a"] = 2;
+    EXPECT_NE(n1, n2);
+
+    // 深层修改使所有包含该数据的集合失效，包括引用同一数据的其它节点树
+    auto t1 = cyaml::load("{a: {b: [1]}}");
+    auto t2 = cyaml::load("{x: 0}");
+    t2["x"] = t1["a"]["b"];
+    t1.hash();
+    t2.hash();
+    t2["x"].push_back(2);
+    EXPECT_EQ(t1.hash(), cyaml::load("{a: {b: [1, 2]}}").hash());
+    EXPECT_EQ(t2.hash(), cyaml::load("{x: [1, 2]}").hash());
+
+    // 写时复制的克隆节点修改后同样失效
+    auto frozen = cyaml::load("{a: {b: [1]}}");
+    frozen.freeze();
+    auto copy = frozen.clone();
+    copy.hash();
+    copy["a"]["b"][0] = 3;
+    EXPECT_EQ(copy.hash(), cyaml::load("{a: {b: [3]}}").hash());
+
+    // 键顺序不同的 map 不相等
+    EXPECT_NE(cyaml::load("{a: 1, b: 2}"), cyaml::load("{b: 2, a: 1}"));
+
+    // 冻结后哈希不再变化
+    n1.freeze();
+    cyaml::Node n3 = n1.clone();
+    EXPECT_EQ(n3.hash(), n1.hash());
+    n3["a"] = 3;
+    EXPECT_NE(n3, n1);
+
+    std::unordered_set<cyaml::Node> set;
+    set.insert(cyaml::load("[1, 2]"));
+    set.insert(cyaml::load("[1, 2]"));
+    set.insert(cyaml::Node("1"));
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_EQ(set.count(cyaml::load("[1, 2]")), 1);
+}
+
+TEST_F(Parser_Test, diff_patch)
+{
+    auto old_node = cyaml::load(
+            "{limits: {max_conns: 100, timeout: 30}, hosts: [a, b, c], "
+            "log: debug, removed: 1}");
+    auto new_node = cyaml::load(
+            "{limits: {max_conns: 200, timeout: 30}, hosts: [a, x], "
+            "log: {level: info}, added: [1, 2]}");
+
+    auto patch = cyaml::diff(old_node, new_node);
+    ASSERT_EQ(patch.size(), 6);
+
+    EXPECT_EQ(patch[0].op, cyaml::Patch_Op::REPLACE);
+    ASSERT_EQ(patch[0].path.size(), 2);
+    EXPECT_EQ(patch[0].path[0].as<std::string>(), "limits");
+    EXPECT_EQ(patch[0].path[1].as<std::string>(), "max_conns");
+    EXPECT_EQ(patch[0].value.as<int>(), 200);
+
+    EXPECT_EQ(patch[1].op, cyaml::Patch_Op::REPLACE);
+    EXPECT_EQ(patch[1].path[1].as<int>(), 1);
+    EXPECT_EQ(patch[2].op, cyaml::Patch_Op::REMOVE);
+    EXPECT_EQ(patch[2].path[1].as<int>(), 2);
+    EXPECT_EQ(patch[3].op, cyaml::Patch_Op::REPLACE);
+    EXPECT_EQ(patch[4].op, cyaml::Patch_Op::REMOVE);
+    EXPECT_EQ(patch[5].op, cyaml::Patch_Op::ADD);
+    EXPECT_EQ(patch[5].path[0].as<std::string>(), "added");
+
+    cyaml::Node target = old_node.clone();
+    cyaml::apply_patch(target, patch);
+    EXPECT_EQ(target["limits"], new_node["limits"]);
+    EXPECT_EQ(target["hosts"], new_node["hosts"]);
+    EXPECT_EQ(target["log"], new_node["log"]);
+    EXPECT_EQ(target["added"], new_node["added"]);
+    EXPECT_FALSE(target.contain("removed"));
+    EXPECT_EQ(target.size(), new_node.size());
+
+    // 补丁中的值独立于节点树
+    target["added"].push_back(3);
+    EXPECT_EQ(patch[5].value.size(), 2);
+
+    // 相同的节点树没有差异
+    EXPECT_TRUE(cyaml::diff(new_node, new_node.clone()).empty());
+    new_node.freeze();
+    EXPECT_TRUE(cyaml::diff(new_node, new_node.clone()).empty());
+
+    // 在数组开头插入只记录一条添加，相同的开头和结尾不产生修改
+    auto front = cyaml::load("[b, c, d, e, f]");
+    auto inserted = cyaml::load("[a, b, c, d, e, f]");
+    auto insert_patch = cyaml::diff(front, inserted);
+    ASSERT_EQ(insert_patch.size(), 1);
+    EXPECT_EQ(insert_patch[0].op, cyaml::Patch_Op::ADD);
+    EXPECT_EQ(insert_patch[0].path[0].as<int>(), 0);
+    cyaml::apply_patch(front, insert_patch);
+    EXPECT_EQ(front, inserted);
+
+    auto middle = cyaml::diff(
+            cyaml::load("[a, b, c, d]"), cyaml::load("[a, x, y, d]"));
+    ASSERT_EQ(middle.size(), 2);
+    EXPECT_EQ(middle[0].path[0].as<int>(), 1);
+    EXPECT_EQ(middle[1].path[0].as<int>(), 2);
+    EXPECT_EQ(
+            cyaml::diff(cyaml::load("[a, b, c]"), cyaml::load("[a, c]"))
+                    .size(),
+            1);
+
+    // 键顺序不计入差异，应用补丁后不会恢复
+    auto ordered = cyaml::load("{a: 1, b: 2}");
+    auto reordered = cyaml::load("{b: 2, a: 3}");
+    apply_patch(ordered, cyaml::diff(ordered, reordered));
+    EXPECT_EQ(ordered["a"].as<int>(), 3);
+    EXPECT_EQ(cyaml::dump(ordered), "{a: 3, b: 2}");
+    EXPECT_NE(ordered, reordered);
+
+    // 路径不存在
+    cyaml::Node other = cyaml::load("{a: 1}");
+    EXPECT_THROW(
+            cyaml::apply_patch(other, patch), cyaml::Dereference_Exception);
+}
+
+TEST_F(Parser_Test, memory_usage)
+{
+    cyaml::Node node = cyaml::load(
+            "name: a long scalar value that is not stored inline\n"
+            "list: [1, 2, 3, 4]\n"
+            "map: {a: {b: [x, y]}, c: null}\n");
+
+    auto usage = cyaml::memory_usage(node, 2);
+    EXPECT_EQ(usage.map_count, 3);
+    EXPECT_EQ(usage.seq_count, 2);
+    EXPECT_EQ(usage.null_count, 1);
+    EXPECT_EQ(usage.scalar_count, 13);
+    EXPECT_EQ(usage.max_depth, 5);
+    EXPECT_EQ(usage.shared_count, 0);
+    EXPECT_GT(usage.scalar_bytes, 0);
+    EXPECT_GT(usage.container_bytes, 0);
+    EXPECT_EQ(usage.source_bytes, 0);
+    EXPECT_EQ(
+            usage.total(), usage.node_bytes + usage.data_bytes +
+                                   usage.container_bytes + usage.scalar_bytes +
+                                   usage.ref_bytes);
+
+    ASSERT_EQ(usage.largest.size(), 2);
+    EXPECT_EQ(usage.largest[0].path, "/list");
+    EXPECT_EQ(usage.largest[0].size, 4);
+    EXPECT_EQ(usage.largest[1].size, 3);
+
+    // 共享的数据只统计一次
+    cyaml::Node alias = cyaml::load("a: &x [1, 2, 3]\nb: *x\n");
+    auto alias_usage = cyaml::memory_usage(alias);
+    EXPECT_EQ(alias_usage.shared_count, 1);
+    EXPECT_EQ(alias_usage.seq_count, 2);
+    EXPECT_EQ(alias_usage.scalar_count, 5);
+
+    // 不构建延迟加载的子节点
+    cyaml::Node lazy = cyaml::load_lazy("a:\n  b: 1\n");
+    auto lazy_usage = cyaml::memory_usage(lazy);
+    EXPECT_EQ(lazy_usage.lazy_count, 1);
+    EXPECT_EQ(lazy_usage.map_count, 2);
+    EXPECT_GT(lazy_usage.source_bytes, 0);
+    EXPECT_EQ(lazy["a"]["b"].as<int>(), 1);
+    EXPECT_EQ(cyaml::memory_usage(lazy).lazy_count, 0);
+}
+
+TEST_F(Parser_Test, intern)
+{
+    std::string input;
+    for (int i = 0; i < 100; i++) {
+        input += "- region: us-east\n"
+                 "  image: nginx:1.25\n"
+                 "  port: \"80\"\n"
+                 "  extra:\n"
+                 "  tags: [web, public]\n";
+    }
+
+    cyaml::Node plain = cyaml::load(input);
+    cyaml::Node scalar = cyaml::load(input, cyaml::Intern_Mode::SCALAR);
+    cyaml::Node subtree = cyaml::load(input, cyaml::Intern_Mode::SUBTREE);
+
+    EXPECT_EQ(plain, scalar);
+    EXPECT_EQ(plain, subtree);
+    EXPECT_EQ(cyaml::dump(plain), cyaml::dump(subtree));
+
+    // 加载时逐层合并的哈希与重新计算的结果相同
+    EXPECT_EQ(subtree.hash(), plain.hash());
+    EXPECT_EQ(subtree[0]["tags"].hash(), plain[0]["tags"].hash());
+
+    // 重复的文档占用的内存明显减少
+    size_t plain_bytes = cyaml::memory_usage(plain).total();
+    EXPECT_LT(cyaml::memory_usage(scalar).total() * 2, plain_bytes);
+    EXPECT_LT(cyaml::memory_usage(subtree).total() * 10, plain_bytes);
+
+    // 修改只影响当前节点
+    for (auto *root : {&scalar, &subtree}) {
+        cyaml::Node &node = *root;
+        node[0]["region"] = "eu-west";
+        node[0]["tags"].push_back("internal");
+        node[0]["extra"]["key"] = 1;
+        EXPECT_EQ(node[0]["region"].as<std::string>(), "eu-west");
+        EXPECT_EQ(node[0]["tags"].size(), 3);
+        EXPECT_EQ(node[0]["extra"]["key"].as<int>(), 1);
+        EXPECT_EQ(node[1], plain[1]);
+    }
+
+    subtree.freeze();
+    EXPECT_EQ(subtree[2], plain[2]);
+    EXPECT_EQ(subtree.clone()[3], plain[3]);
+}
+
+TEST_F(Parser_Test, key_table)
+{
+    cyaml::Key_Table table;
+    std::string input = "name: a\n"
+                        "port: 1\n"
+                        "nested:\n"
+                        "  name: b\n"
+                        "  ? [x]\n"
+                        "  : 2\n";
+    cyaml::Node first = cyaml::load(input, table);
+    cyaml::Node second = cyaml::load("- name: c\n  port: 2\n", table);
+
+    // 集合键不放入键表
+    EXPECT_EQ(table.size(), 3);
+    EXPECT_EQ(first, cyaml::load(input));
+    EXPECT_TRUE(first.keys()[0].is_frozen());
+
+    cyaml::Node name = table.key("name");
+    EXPECT_EQ(first[name].as<std::string>(), "a");
+    EXPECT_EQ(first["nested"][name].as<std::string>(), "b");
+    EXPECT_EQ(second[0][name].as<std::string>(), "c");
+
+    // 修改文档不影响键表和其它文档
+    first["name"] = "d";
+    first["added"] = 1;
+    EXPECT_EQ(first[name].as<std::string>(), "d");
+    EXPECT_EQ(second[0][name].as<std::string>(), "c");
+    EXPECT_EQ(table.size(), 3);
+
+    // 可以与节点数据共享同时使用
+    cyaml::Node shared =
+            cyaml::load(input, table, cyaml::Intern_Mode::SUBTREE);
+    EXPECT_EQ(shared, cyaml::load(input));
+}
+
 int main(int argc, char *argv[])
 {
     testing::InitGoogleTest(&argc, argv);
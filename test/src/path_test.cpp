@@ -0,0 +1,177 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cyaml/cyaml.h"
+#include "gtest/gtest.h"
+
+class Path_Test: public testing::Test
+{
+public:
+    const std::string input =
+            "server:\n"
+            "  host: localhost\n"
+            "  ports: [80, 443]\n"
+            "clients:\n"
+            "  - name: a\n"
+            "    port: 1\n"
+            "  - name: b\n"
+            "    port: 2\n"
+            "a/b: slash\n"
+            "m~n: tilde\n"
+            "? [complex, key]\n"
+            ": {port: 3}\n";
+
+    static void SetUpTestSuite()
+    {
+        std::cout << "path test start..." << std::endl;
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::cout << "path test finish" << std::endl;
+    }
+};
+
+TEST_F(Path_Test, compile)
+{
+    EXPECT_TRUE(cyaml::Path("").segments().empty());
+    EXPECT_EQ(cyaml::Path("/").segments().size(), 1);
+
+    cyaml::Path path("/a~1b/*/**/**/0");
+    auto &segments = path.segments();
+    ASSERT_EQ(segments.size(), 4);
+    EXPECT_EQ(segments[0].key, "a/b");
+    EXPECT_EQ(segments[1].type, cyaml::Path_Segment_Type::ANY);
+    EXPECT_EQ(segments[2].type, cyaml::Path_Segment_Type::RECURSIVE);
+    EXPECT_EQ(segments[3].index, 0);
+
+    EXPECT_THROW(cyaml::Path("a"), cyaml::Parse_Exception);
+    EXPECT_THROW(cyaml::Path("/a~2"), cyaml::Parse_Exception);
+}
+
+TEST_F(Path_Test, node)
+{
+    auto root = cyaml::load(input);
+
+    EXPECT_EQ(cyaml::Path("").find(root), &root);
+    EXPECT_EQ(
+            cyaml::Path("/server/host").find(root)->as<std::string>(),
+            "localhost");
+    EXPECT_EQ(cyaml::Path("/server/ports/1").find(root)->as<int>(), 443);
+    EXPECT_EQ(cyaml::Path("/a~1b").find(root)->as<std::string>(), "slash");
+    EXPECT_EQ(cyaml::Path("/m~0n").find(root)->as<std::string>(), "tilde");
+
+    // 路径不存在时不抛出异常
+    EXPECT_EQ(cyaml::Path("/server/missing").find(root), nullptr);
+    EXPECT_EQ(cyaml::Path("/server/ports/2").find(root), nullptr);
+    EXPECT_EQ(cyaml::Path("/server/host/x").find(root), nullptr);
+
+    auto names = cyaml::Path("/clients/*/name").select(root);
+    ASSERT_EQ(names.size(), 2);
+    EXPECT_EQ(names[0]->as<std::string>(), "a");
+    EXPECT_EQ(names[1]->as<std::string>(), "b");
+
+    // 递归查找，包括集合键对应的值
+    auto ports = cyaml::Path("/**/port").select(root);
+    ASSERT_EQ(ports.size(), 3);
+    EXPECT_EQ(ports[2]->as<int>(), 3);
+}
+
+TEST_F(Path_Test, stream)
+{
+    auto root = cyaml::load(input);
+
+    for (auto expr :
+         {"", "/server", "/server/ports/0", "/clients/*/name", "/**/port",
+          "/**", "/missing"}) {
+        cyaml::Path path(expr);
+        auto nodes = cyaml::select(input, path);
+        auto expected = path.select(root);
+
+        // 事件流中匹配节点的子孙节点不会再单独匹配
+        if (std::string(expr) == "/**") {
+            ASSERT_EQ(nodes.size(), 1);
+            EXPECT_EQ(nodes[0], root);
+            continue;
+        }
+
+        ASSERT_EQ(nodes.size(), expected.size()) << expr;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            EXPECT_EQ(nodes[i], *expected[i]) << expr;
+        }
+    }
+
+    // 嵌套匹配时只返回最外层的节点
+    std::string nested = "{0: {/: {}, b: x}}";
+    cyaml::Path any("/**");
+    EXPECT_EQ(any.select(cyaml::load(nested)).size(), 4);
+    auto outer = cyaml::select(nested, any);
+    ASSERT_EQ(outer.size(), 1);
+    EXPECT_EQ(outer[0], cyaml::load(nested));
+
+    // block 集合之后的 "---" 结束第一个文档
+    auto first = cyaml::select("a:\n  b: 1\n---\nc: 2\n", cyaml::Path("/a/b"));
+    ASSERT_EQ(first.size(), 1);
+    EXPECT_EQ(first[0].as<int>(), 1);
+    EXPECT_TRUE(cyaml::select(
+                        "---\na:\n  b: 1\n---\nc: 2\n", cyaml::Path("/c"))
+                        .empty());
+
+    std::vector<std::string> locations;
+    cyaml::Path_Handler handler(
+            cyaml::Path("/clients/*/port"),
+            [&](const cyaml::Path_Handler::Location &location,
+                const cyaml::Node &node) {
+                std::string str;
+                for (auto &component : location) {
+                    str += '/';
+                    if (component.index >= 0)
+                        str += std::to_string(component.index);
+                    else
+                        str += component.key;
+                }
+                locations.push_back(str + "=" + node.as<std::string>());
+            });
+    std::stringstream ss(input);
+    cyaml::Parser(ss, handler).parse_next_document();
+    EXPECT_EQ(
+            locations,
+            std::vector<std::string>(
+                    {"/clients/0/port=1", "/clients/1/port=2"}));
+}
+
+TEST_F(Path_Test, selective_load)
+{
+    auto root = cyaml::load(input);
+
+    auto node = cyaml::load(
+            input, {cyaml::Path("/server/host"), cyaml::Path("/clients/1")});
+    ASSERT_TRUE(node.is_map());
+    EXPECT_EQ(node.size(), 2);
+    EXPECT_EQ(node["server"].size(), 1);
+    EXPECT_EQ(node["server"]["host"].as<std::string>(), "localhost");
+
+    // 未选中的元素以空值占位，下标不变
+    ASSERT_EQ(node["clients"].size(), 2);
+    EXPECT_TRUE(node["clients"][0].is_null());
+    EXPECT_EQ(node["clients"][1], root["clients"][1]);
+
+    EXPECT_EQ(cyaml::load(input, cyaml::Path("")), root);
+    EXPECT_TRUE(cyaml::load(input, cyaml::Path("/missing")).is_null());
+
+    // 位置判断函数
+    node = cyaml::load(input, [](const cyaml::Selector::Location &location) {
+        return location.size() == 3 && location[2].key == "port";
+    });
+    EXPECT_EQ(node.size(), 1);
+    EXPECT_EQ(node["clients"].size(), 2);
+    EXPECT_EQ(node["clients"][0]["port"].as<int>(), 1);
+    EXPECT_EQ(node["clients"][1]["port"].as<int>(), 2);
+    EXPECT_FALSE(node["clients"][1].contain("name"));
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
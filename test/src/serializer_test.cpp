@@ -2,9 +2,37 @@
 #include <fstream>
 #include <string>
 #include <exception>
+#include <sstream>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
 #include "cyaml/cyaml.h"
 #include "gtest/gtest.h"
 
+static std::atomic<size_t> allocations{0}; // 全局 new 调用次数
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *p = std::malloc(size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
 class Serializer_Test: public testing::Test
 {
 public:
@@ -49,8 +77,433 @@ TEST_F(Serializer_Test, temp)
     cyaml::dump("test.yaml", node);
 }
 
+TEST_F(Serializer_Test, flow_map)
+{
+    auto node = cyaml::load("{a: {b: 1, c: [2, 3]}}");
+    EXPECT_EQ(cyaml::dump(node["a"]), "{b: 1, c: [2, 3]}");
+    EXPECT_EQ(cyaml::load(cyaml::dump(node)), node);
+}
+
+TEST_F(Serializer_Test, output)
+{
+    std::string str;
+    {
+        cyaml::Output out(str);
+        out.write("ab\ncd");
+        EXPECT_EQ(out.line(), 2);
+        EXPECT_EQ(out.column(), 3);
+        out.write_space(100);
+        out.write(':');
+        EXPECT_EQ(out.column(), 104);
+        out.write_new_line(2);
+        EXPECT_EQ(out.line(), 4);
+        EXPECT_EQ(out.column(), 1);
+
+        // 超过缓冲区大小的内容直接写出
+        out.write(std::string(cyaml::Output::BUFFER_SIZE + 1, 'x'));
+        EXPECT_EQ(out.column(), cyaml::Output::BUFFER_SIZE + 2);
+    }
+    EXPECT_EQ(str.size(), 5 + 100 + 1 + 2 + cyaml::Output::BUFFER_SIZE + 1);
+    EXPECT_EQ(str.substr(0, 6), "ab\ncd ");
+
+    // 输出到文件描述符
+    auto node = cyaml::load("a: [1, 2]\nb:\n  c: d\n");
+    FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    cyaml::Serializer(fileno(file)).serialize(node);
+    std::rewind(file);
+    char buffer[256]{};
+    size_t size = std::fread(buffer, 1, sizeof(buffer), file);
+    std::fclose(file);
+    EXPECT_EQ(std::string(buffer, size), cyaml::dump(node));
+}
+
+TEST_F(Serializer_Test, allocation)
+{
+    cyaml::Node node;
+    for (int i = 0; i < 10000; i++) {
+        cyaml::Node item;
+        item["name"] = "item" + std::to_string(i);
+        item["tags"].push_back("");
+        item["tags"].set_style(cyaml::Node_Style::FLOW);
+        node.push_back(item);
+    }
+    node.freeze();
+
+    std::string expected;
+    {
+        std::ostringstream oss;
+        oss << node;
+        expected = oss.str();
+    }
+
+    // 输出过程中只分配缓冲区
+    std::string str;
+    str.reserve(expected.size());
+    size_t before = allocations;
+    cyaml::Serializer(str).serialize(node);
+    EXPECT_LE(allocations - before, 1);
+    EXPECT_EQ(str, expected);
+}
+
+TEST_F(Serializer_Test, emitter)
+{
+    auto node = cyaml::load(
+            "a: 1\n"
+            "b:\n"
+            "  - x\n"
+            "  - {c: [1, 2], d: \"\"}\n"
+            "  -\n"
+            "    e: null\n"
+            "? [k1, k2]\n"
+            ": f\n");
+
+    // 直接调用，格式与 Serializer 相同
+    std::string str;
+    {
+        cyaml::Emitter emitter(str);
+        emitter.begin_map();
+        emitter.scalar("a");
+        emitter.scalar("1");
+        emitter.scalar("b");
+        emitter.begin_seq();
+        emitter.scalar("x");
+        emitter.begin_map(cyaml::Node_Style::FLOW);
+        emitter.scalar("c");
+        emitter.begin_seq(cyaml::Node_Style::BLOCK);
+        emitter.scalar("1");
+        emitter.scalar("2");
+        emitter.end_seq();
+        emitter.scalar("d");
+        emitter.scalar("");
+        emitter.end_map();
+        emitter.begin_map();
+        emitter.scalar("e");
+        emitter.null();
+        emitter.end_map();
+        emitter.end_seq();
+        emitter.begin_seq(cyaml::Node_Style::FLOW);
+        emitter.scalar("k1");
+        emitter.scalar("k2");
+        emitter.end_seq();
+        emitter.scalar("f");
+        emitter.end_map();
+    }
+    EXPECT_EQ(str, cyaml::dump(node));
+
+    // 解析事件直接输出，锚点和别名不展开
+    std::string input = "a: &x [1, 2]\nb: *x\nc: &y\n  d: 3\n";
+    std::istringstream iss(input);
+    str.clear();
+    {
+        cyaml::Emitter emitter(str);
+        cyaml::Parser parser(iss, emitter);
+        while (parser.parse_next_document()) {
+        }
+    }
+    EXPECT_EQ(str, "a: &x [1, 2]\nb: *x\nc: &y\n  d: 3\n");
+    EXPECT_EQ(cyaml::load(str), cyaml::load(input));
+
+    // 多个文档
+    str.clear();
+    {
+        cyaml::Emitter emitter(str);
+        emitter.begin_document();
+        emitter.scalar("1");
+        emitter.end_document();
+        emitter.begin_document();
+        emitter.begin_seq();
+        emitter.scalar("2");
+        emitter.end_seq();
+        emitter.end_document();
+    }
+    EXPECT_EQ(str, "1\n---\n- 2\n");
+
+    // 调用顺序错误
+    cyaml::Emitter emitter(str);
+    emitter.begin_map();
+    emitter.scalar("a");
+    EXPECT_THROW(emitter.end_map(), cyaml::Exception);
+    EXPECT_THROW(emitter.end_seq(), cyaml::Exception);
+    emitter.scalar("b");
+    emitter.end_map();
+    EXPECT_THROW(emitter.scalar("c"), cyaml::Exception);
+}
+
+TEST_F(Serializer_Test, emitter_allocation)
+{
+    std::string expected;
+    {
+        cyaml::Node node;
+        for (int i = 0; i < 10000; i++) {
+            cyaml::Node item;
+            item["id"] = i;
+            item["tags"].push_back("a");
+            item["tags"].set_style(cyaml::Node_Style::FLOW);
+            node.push_back(item);
+        }
+        expected = cyaml::dump(node);
+    }
+
+    // 输出过程中只分配缓冲区和集合栈
+    std::string str;
+    str.reserve(expected.size());
+    std::string id;
+    id.reserve(16);
+    size_t before = allocations;
+    {
+        cyaml::Emitter emitter(str);
+        emitter.begin_seq();
+        for (int i = 0; i < 10000; i++) {
+            id.clear();
+            for (int n = i;; n /= 10) {
+                id.insert(id.begin(), char('0' + n % 10));
+                if (n < 10)
+                    break;
+            }
+            emitter.begin_map();
+            emitter.scalar("id");
+            emitter.scalar(id);
+            emitter.scalar("tags");
+            emitter.begin_seq(cyaml::Node_Style::FLOW);
+            emitter.scalar("a");
+            emitter.end_seq();
+            emitter.end_map();
+        }
+        emitter.end_seq();
+    }
+    EXPECT_LE(allocations - before, 4);
+    EXPECT_EQ(str, expected);
+}
+
+TEST_F(Serializer_Test, format)
+{
+    auto node = cyaml::load(
+            "a: [1, +2, 0x1F, 1.5, .5, .inf, true, False, yes, \"\", \"~\"]\n"
+            "b:\n"
+            "  c: \"x\\ty\\\"z\\\\\"\n"
+            "  d: a, b\n"
+            "  \"e: f\": \"#g\"\n"
+            "  h: null\n");
+
+    EXPECT_EQ(
+            cyaml::dump(node, cyaml::Dump_Format::JSON),
+            "{\"a\":[1,2,31,1.5,0.5,\".inf\",true,false,\"yes\",\"\",\"~\"],"
+            "\"b\":{\"c\":\"x\\ty\\\"z\\\\\",\"d\":\"a, b\",\"e: f\":\"#g\","
+            "\"h\":null}}");
+
+    std::string flow = cyaml::dump(node, cyaml::Dump_Format::FLOW);
+    EXPECT_EQ(
+            flow,
+            "{a: [1,+2,0x1F,1.5,.5,.inf,true,False,yes,\"\",\"~\"],"
+            "b: {c: \"x\\ty\\\"z\\\\\",d: 'a, b','e: f': '#g',"
+            "h: null}}");
+    EXPECT_EQ(cyaml::load(flow), node);
+
+    // JSON 转义其余控制字符，键只能是标量
+    cyaml::Node control;
+    control.push_back(std::string("\x01", 1));
+    EXPECT_EQ(cyaml::dump(control, cyaml::Dump_Format::JSON), "[\"\\u0001\"]");
+
+    cyaml::Node key;
+    key.push_back(1);
+    cyaml::Node map;
+    map[key] = 2;
+    EXPECT_THROW(
+            cyaml::dump(map, cyaml::Dump_Format::JSON),
+            cyaml::Representation_Exception);
+}
+
+TEST_F(Serializer_Test, scalar_style)
+{
+    using cyaml::classify_scalar;
+    using cyaml::Scalar_Context;
+    using cyaml::Scalar_Style;
+
+    auto block = Scalar_Context::BLOCK;
+    EXPECT_EQ(classify_scalar("plain text", block), Scalar_Style::PLAIN);
+    EXPECT_EQ(classify_scalar("a,b [c]", block), Scalar_Style::PLAIN);
+    EXPECT_EQ(classify_scalar("a#b:c", block), Scalar_Style::PLAIN);
+    EXPECT_EQ(classify_scalar("-1", block), Scalar_Style::PLAIN);
+    EXPECT_EQ(classify_scalar("null", block), Scalar_Style::DOUBLE_QUOTED);
+    EXPECT_EQ(classify_scalar("a: b", block), Scalar_Style::SINGLE_QUOTED);
+    EXPECT_EQ(classify_scalar("a #b", block), Scalar_Style::SINGLE_QUOTED);
+    EXPECT_EQ(classify_scalar("- a", block), Scalar_Style::SINGLE_QUOTED);
+    EXPECT_EQ(classify_scalar("*a", block), Scalar_Style::SINGLE_QUOTED);
+    EXPECT_EQ(classify_scalar(" a", block), Scalar_Style::SINGLE_QUOTED);
+    EXPECT_EQ(classify_scalar("it's: x", block), Scalar_Style::DOUBLE_QUOTED);
+    EXPECT_EQ(classify_scalar("a\tb", block), Scalar_Style::DOUBLE_QUOTED);
+    EXPECT_EQ(classify_scalar("a\nb\n", block), Scalar_Style::LITERAL);
+    EXPECT_EQ(classify_scalar("a\n  b", block), Scalar_Style::DOUBLE_QUOTED);
+    EXPECT_EQ(
+            classify_scalar("a\nb", Scalar_Context::KEY),
+            Scalar_Style::DOUBLE_QUOTED);
+    EXPECT_EQ(
+            classify_scalar("a,b", Scalar_Context::FLOW),
+            Scalar_Style::SINGLE_QUOTED);
+
+    // 较长的字符串按 8 字节一组检查，特殊字符位于组中任意位置
+    std::string text(64, 'x');
+    EXPECT_EQ(classify_scalar(text, block), Scalar_Style::PLAIN);
+    for (size_t i = 1; i < text.size(); i++) {
+        std::string str = text;
+        str[i] = '\x01';
+        EXPECT_EQ(classify_scalar(str, block), Scalar_Style::DOUBLE_QUOTED);
+    }
+
+    cyaml::Node node;
+    node["key: 1"] = "a: b";
+    node["text"] = "first line\nsecond line\n";
+    node["escape"] = "tab\there \"quoted\" \\ \x01\x7f";
+    node["seq"].push_back("#comment");
+    node["seq"].push_back("x, y");
+    node["seq"].set_style(cyaml::Node_Style::FLOW);
+    EXPECT_EQ(
+            cyaml::dump(node),
+            "'key: 1': 'a: b'\n"
+            "text: |\n"
+            "  first line\n"
+            "  second line\n"
+            "escape: \"tab\\there \\\"quoted\\\" \\\\ \\x01\\x7f\"\n"
+            "seq: ['#comment', 'x, y']\n");
+    EXPECT_EQ(cyaml::load(cyaml::dump(node)), node);
+    EXPECT_EQ(
+            cyaml::load(cyaml::dump(node, cyaml::Dump_Format::FLOW)), node);
+}
+
+TEST_F(Serializer_Test, dump_to)
+{
+    auto node = cyaml::load("a: [1, 2]\nb:\n  c: \"d: e\"\n  f: |\n    g\n");
+    std::string expected = cyaml::dump(node);
+    EXPECT_EQ(cyaml::dump_size(node), expected.size());
+    EXPECT_EQ(
+            cyaml::dump_size(node, cyaml::Dump_Format::JSON),
+            cyaml::dump(node, cyaml::Dump_Format::JSON).size());
+
+    // 容量不足时调整一次大小，替换原有内容
+    std::string str = "old";
+    cyaml::dump_to(str, node);
+    EXPECT_EQ(str, expected);
+
+    // 重复使用时直接写入已有容量，不分配内存
+    str.reserve(1024);
+    size_t before = allocations;
+    cyaml::dump_to(str, node);
+    EXPECT_EQ(allocations - before, 0);
+    EXPECT_EQ(str, expected);
+
+    // 写入调用者的内存，超出容量时截断并返回完整长度
+    char buffer[256];
+    EXPECT_EQ(cyaml::dump_to(buffer, sizeof(buffer), node), expected.size());
+    EXPECT_EQ(std::string(buffer, expected.size()), expected);
+
+    std::memset(buffer, '#', sizeof(buffer));
+    EXPECT_EQ(cyaml::dump_to(buffer, 5, node), expected.size());
+    EXPECT_EQ(std::string(buffer, 6), expected.substr(0, 5) + "#");
+}
+
+TEST_F(Serializer_Test, parallel)
+{
+    const cyaml::Dump_Format formats[] = {
+            cyaml::Dump_Format::YAML, cyaml::Dump_Format::FLOW,
+            cyaml::Dump_Format::JSON};
+
+    cyaml::Node seq, map;
+    for (int i = 0; i < 200; i++) {
+        cyaml::Node item;
+        item["name"] = "item " + std::to_string(i);
+        item["text"] = "line\nnext: " + std::to_string(i) + "\n";
+        item["tags"].push_back(i);
+        item["tags"].push_back("a, b");
+        item["tags"].set_style(cyaml::Node_Style::FLOW);
+        seq.push_back(item);
+        map["key " + std::to_string(i)] = item;
+    }
+
+    // 未冻结时按单线程输出
+    EXPECT_EQ(cyaml::dump_parallel(seq, formats[0], 4), cyaml::dump(seq));
+
+    seq.freeze();
+    map.freeze();
+    for (auto format : formats) {
+        for (size_t threads : {2, 3, 8}) {
+            EXPECT_EQ(
+                    cyaml::dump_parallel(seq, format, threads),
+                    cyaml::dump(seq, format));
+            EXPECT_EQ(
+                    cyaml::dump_parallel(map, format, threads),
+                    cyaml::dump(map, format));
+        }
+    }
+
+    // 条目不以换行结束时按单线程输出
+    auto node = cyaml::load("? [1, 2]\n: {}\n? [3]\n: {}\n");
+    node.freeze();
+    EXPECT_EQ(cyaml::dump_parallel(node, formats[0], 2), cyaml::dump(node));
+
+    // 工作线程中的异常在调用线程抛出
+    auto complex = cyaml::load("? [1]\n: a\n? [2]\n: b\n");
+    complex.freeze();
+    EXPECT_THROW(
+            cyaml::dump_parallel(complex, cyaml::Dump_Format::JSON, 2),
+            cyaml::Representation_Exception);
+}
+
 int main(int argc, char *argv[])
 {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+TEST_F(Serializer_Test, depth)
+{
+    const uint32_t depth = 20000;
+
+    // 自顶向下构建，避免赋值时绑定引用
+    cyaml::Node seq, map;
+    cyaml::Node *cur = &seq;
+    for (uint32_t i = 0; i < depth; i++) {
+        cur->push_back(cyaml::Node());
+        cur = &(*cur)[0u];
+    }
+    *cur = "x";
+    cur = &map;
+    for (uint32_t i = 0; i < 100; i++)
+        cur = &(*cur)["k"];
+    *cur = "v";
+
+    // 超过默认限制时抛出异常，调整限制后不受调用栈大小影响
+    EXPECT_THROW(
+            cyaml::dump(seq, cyaml::Dump_Format::JSON),
+            cyaml::Representation_Exception);
+
+    std::string out;
+    cyaml::Serializer serializer(out, cyaml::Dump_Format::JSON);
+    serializer.set_max_depth(depth);
+    serializer.serialize(seq);
+    EXPECT_EQ(
+            out,
+            std::string(depth, '[') + "\"x\"" + std::string(depth, ']'));
+
+    std::string expected;
+    for (uint32_t i = 0; i < 99; i++)
+        expected += std::string(2 * i, ' ') + "k: \n";
+    expected += std::string(2 * 99, ' ') + "k: v\n";
+    EXPECT_EQ(cyaml::dump(map), expected);
+
+    std::string block;
+    cyaml::Serializer limited(block);
+    limited.set_max_depth(99);
+    EXPECT_THROW(limited.serialize(map), cyaml::Representation_Exception);
+
+    // 引用形成环时停止输出
+    cyaml::Node a, b;
+    a["k"] = "v";
+    b["a"] = a;
+    a["b"] = b;
+    EXPECT_THROW(cyaml::dump(a), cyaml::Representation_Exception);
+    EXPECT_THROW(
+            cyaml::dump(a, cyaml::Dump_Format::JSON),
+            cyaml::Representation_Exception);
+    a.erase(cyaml::Node(std::string("b")));
+}
@@ -0,0 +1,319 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "cyaml/cyaml.h"
+#include "gtest/gtest.h"
+
+static std::atomic<size_t> allocations{0}; // 全局 new 调用次数
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *p = std::malloc(size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * @brief   比较快照中的节点与节点树
+ * @param   mapped  快照中的节点
+ * @param   node    节点
+ * @return  bool
+ */
+static bool same(const cyaml::Mapped_Node &mapped, const cyaml::Node &node)
+{
+    if (mapped.type() != node.type() || mapped.style() != node.style())
+        return false;
+
+    if (node.is_scalar())
+        return mapped.scalar_view() == node.scalar_view();
+    if (mapped.size() != node.size())
+        return false;
+
+    uint32_t i = 0;
+    for (auto [key, value] : node) {
+        if (node.is_seq() && !same(mapped[i], value))
+            return false;
+        if (node.is_map() &&
+            (!same(mapped.key(i), key) || !same(mapped.value(i), value))) {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+class Snapshot_Test: public testing::Test
+{
+public:
+    const std::string test_case_dirname = "../test/test_case/parser_test/";
+
+    const std::string input = "server:\n"
+                              "  host: localhost\n"
+                              "  ports: [80, 443]\n"
+                              "  tls:\n"
+                              "    key: |\n"
+                              "      line 1\n"
+                              "      line 2\n"
+                              "clients:\n"
+                              "- name: a\n"
+                              "  tags: {x: 1, y: [2, 3]}\n"
+                              "-\n"
+                              "- \"\\ttab\"\n"
+                              "? [complex, key]\n"
+                              ": {port: 3}\n"
+                              "empty: \"\"\n";
+
+    static void SetUpTestSuite()
+    {
+        std::cout << "snapshot test start..." << std::endl;
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::cout << "snapshot test finish" << std::endl;
+    }
+};
+
+TEST_F(Snapshot_Test, round_trip)
+{
+    auto node = cyaml::load(input);
+    auto loaded = cyaml::load_snapshot(cyaml::save_snapshot(node));
+    EXPECT_EQ(loaded, node);
+    EXPECT_FALSE(loaded.is_frozen());
+
+    // 样式保持不变，输出结果相同
+    EXPECT_EQ(loaded["server"]["ports"].style(), cyaml::Node_Style::FLOW);
+    EXPECT_EQ(cyaml::dump(loaded), cyaml::dump(node));
+
+    // 相同的节点树得到相同的快照
+    EXPECT_EQ(cyaml::save_snapshot(loaded), cyaml::save_snapshot(node));
+
+    // 冻结的节点树加载后仍然冻结
+    node.freeze();
+    loaded = cyaml::load_snapshot(cyaml::save_snapshot(node));
+    EXPECT_TRUE(loaded.is_frozen());
+    EXPECT_EQ(loaded, node);
+
+    for (auto name :
+         {"anchor_alias", "complex_key", "empty_document1", "flow", "json",
+          "json_style", "nested_key", "node"}) {
+        std::ifstream ifs(test_case_dirname + name + ".in");
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        auto expected = cyaml::load(ss.str());
+        EXPECT_EQ(
+                cyaml::load_snapshot(cyaml::save_snapshot(expected)),
+                expected)
+                << name;
+    }
+
+    // 根节点为标量或空值
+    EXPECT_EQ(
+            cyaml::load_snapshot(cyaml::save_snapshot(cyaml::Node("a"))),
+            cyaml::Node("a"));
+    auto null = cyaml::load_snapshot(cyaml::save_snapshot(cyaml::Node()));
+    EXPECT_TRUE(null.is_null());
+}
+
+TEST_F(Snapshot_Test, file)
+{
+    auto node = cyaml::load(input);
+    cyaml::save_snapshot("snapshot_test.cyb", node);
+    EXPECT_EQ(cyaml::load_snapshot_file("snapshot_test.cyb"), node);
+    std::remove("snapshot_test.cyb");
+
+    EXPECT_THROW(
+            cyaml::load_snapshot_file("no_such_dir/a.cyb"), cyaml::Exception);
+}
+
+TEST_F(Snapshot_Test, invalid)
+{
+    std::string data = cyaml::save_snapshot(cyaml::load(input));
+    EXPECT_THROW(cyaml::load_snapshot(""), cyaml::Parse_Exception);
+    EXPECT_THROW(cyaml::load_snapshot(input), cyaml::Parse_Exception);
+
+    // 截断
+    EXPECT_THROW(
+            cyaml::load_snapshot(data.substr(0, data.size() - 4)),
+            cyaml::Parse_Exception);
+
+    // 版本不同
+    std::string version = data;
+    version[offsetof(cyaml::Snapshot_Header, version)]++;
+    EXPECT_THROW(cyaml::load_snapshot(version), cyaml::Parse_Exception);
+
+    // 数据区任意字节被修改时校验和不一致
+    for (size_t i = sizeof(cyaml::Snapshot_Header); i < data.size(); i++) {
+        std::string corrupt = data;
+        corrupt[i] ^= 0x20;
+        EXPECT_THROW(cyaml::load_snapshot(corrupt), cyaml::Parse_Exception)
+                << i;
+    }
+
+    // 校验和一致但偏移错误时不会越界或形成环
+    std::string cycle = data;
+    uint32_t offset = 0;
+    std::memcpy(
+            &cycle[sizeof(cyaml::Snapshot_Header) +
+                   sizeof(cyaml::Snapshot_Record)],
+            &offset, sizeof(offset));
+    cyaml::Snapshot_Header head;
+    std::memcpy(&head, cycle.data(), sizeof(head));
+    head.checksum = cyaml::snapshot_checksum(
+            cycle.data() + sizeof(head), head.size);
+    std::memcpy(&cycle[0], &head, sizeof(head));
+    EXPECT_THROW(cyaml::load_snapshot(cycle), cyaml::Parse_Exception);
+}
+
+TEST_F(Snapshot_Test, depth)
+{
+    const uint32_t depth = 20000;
+
+    // 自顶向下构建，避免赋值时绑定引用
+    cyaml::Node seq;
+    cyaml::Node *cur = &seq;
+    for (uint32_t i = 0; i < depth; i++) {
+        cur->push_back(cyaml::Node());
+        cur = &(*cur)[0u];
+    }
+    *cur = "x";
+
+    // 超过默认限制时抛出异常，调整限制后不受调用栈大小影响
+    EXPECT_THROW(cyaml::save_snapshot(seq), cyaml::Representation_Exception);
+
+    std::string data;
+    cyaml::Snapshot_Writer writer(data);
+    writer.set_max_depth(depth);
+    writer.write(seq);
+    EXPECT_THROW(cyaml::load_snapshot(data), cyaml::Parse_Exception);
+
+    cyaml::Snapshot_Reader reader(data);
+    reader.set_max_depth(depth);
+    cyaml::Node root = reader.root();
+    cur = &root;
+    for (uint32_t i = 0; i < depth; i++) {
+        ASSERT_EQ(cur->size(), 1);
+        cur = &(*cur)[0u];
+    }
+    EXPECT_EQ(cur->as<std::string>(), "x");
+
+    // 引用形成环时停止写入
+    cyaml::Node a, b;
+    a["k"] = "v";
+    b["a"] = a;
+    a["b"] = b;
+    EXPECT_THROW(cyaml::save_snapshot(a), cyaml::Representation_Exception);
+}
+
+TEST_F(Snapshot_Test, mapped)
+{
+    auto node = cyaml::load(input);
+    for (int i = 0; i < 100; i++)
+        node["many"]["key " + std::to_string(i)] = i;
+    cyaml::save_snapshot("mapped_test.cyb", node);
+
+    {
+        cyaml::Mapped_Document doc("mapped_test.cyb");
+        auto root = doc.root();
+        EXPECT_TRUE(same(root, node));
+
+        EXPECT_EQ(root["server"]["host"].scalar_view(), "localhost");
+        EXPECT_EQ(root["server"]["ports"][1].resolve().integer, 443);
+        EXPECT_EQ(root["server"]["ports"].style(), cyaml::Node_Style::FLOW);
+        EXPECT_TRUE(root["clients"][1].is_null());
+        EXPECT_EQ(root["empty"].scalar(), "");
+        EXPECT_TRUE(root.contain("clients"));
+        EXPECT_FALSE(root.contain("client"));
+        EXPECT_FALSE(root["server"]["host"].contain("a"));
+
+        // 条目较多的 map 通过哈希索引查找
+        auto many = root["many"];
+        for (int i = 0; i < 100; i++) {
+            EXPECT_EQ(
+                    many["key " + std::to_string(i)].resolve().integer, i);
+        }
+        EXPECT_FALSE(many.contain("key 100"));
+
+        EXPECT_THROW(root["none"], cyaml::Dereference_Exception);
+        EXPECT_THROW(root[0], cyaml::Dereference_Exception);
+        EXPECT_THROW(root["clients"][3], cyaml::Dereference_Exception);
+        EXPECT_THROW(root.key(root.size()), cyaml::Dereference_Exception);
+
+        // 访问节点不分配内存
+        size_t before = allocations;
+        for (int i = 0; i < 100; i++) {
+            root["many"]["key 42"].resolve();
+            root["server"]["tls"]["key"].scalar_view();
+        }
+        EXPECT_EQ(allocations - before, 0);
+    }
+
+    // 同一文件可以同时加载为节点树
+    EXPECT_EQ(cyaml::load_snapshot_file("mapped_test.cyb"), node);
+    std::remove("mapped_test.cyb");
+}
+
+TEST_F(Snapshot_Test, mapped_invalid)
+{
+    EXPECT_THROW(
+            cyaml::Mapped_Document("no_such_dir/a.cyb"), cyaml::Exception);
+
+    std::ofstream("mapped_test.cyb") << input;
+    EXPECT_THROW(
+            cyaml::Mapped_Document("mapped_test.cyb"), cyaml::Parse_Exception);
+
+    // 不检查校验和时，损坏的偏移在访问时发现
+    std::string data = cyaml::save_snapshot(cyaml::load(input));
+    uint32_t offset = 0;
+    std::memcpy(
+            &data[sizeof(cyaml::Snapshot_Header) +
+                  sizeof(cyaml::Snapshot_Record) + sizeof(uint32_t)],
+            &offset, sizeof(offset));
+    std::ofstream("mapped_test.cyb", std::ios::binary) << data;
+    EXPECT_THROW(
+            cyaml::Mapped_Document("mapped_test.cyb"), cyaml::Parse_Exception);
+
+    cyaml::Mapped_Document doc("mapped_test.cyb", false);
+    EXPECT_EQ(doc.root().key(0).scalar_view(), "server");
+    EXPECT_THROW(doc.root()["server"], cyaml::Parse_Exception);
+
+    // 损坏的条目数在计算索引槽数前被发现
+    EXPECT_EQ(cyaml::snapshot_index_capacity(9), 32);
+    EXPECT_EQ(cyaml::snapshot_index_capacity(0x40000000), 0x80000000);
+    EXPECT_EQ(cyaml::snapshot_index_capacity(0xFFFFFFFF), 0);
+    data = cyaml::save_snapshot(cyaml::load(input));
+    uint32_t size = 0xFFFFFFFF;
+    std::memcpy(
+            &data[sizeof(cyaml::Snapshot_Header) +
+                  offsetof(cyaml::Snapshot_Record, size)],
+            &size, sizeof(size));
+    std::ofstream("mapped_test.cyb", std::ios::binary) << data;
+    cyaml::Mapped_Document corrupt("mapped_test.cyb", false);
+    EXPECT_THROW(corrupt.root(), cyaml::Parse_Exception);
+    std::remove("mapped_test.cyb");
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}